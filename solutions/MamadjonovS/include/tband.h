@@ -0,0 +1,375 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//     LAPACK   LU-
+
+#ifndef __TBand_H__
+#define __TBand_H__
+
+#include <cmath>
+#include <vector>
+
+#include "tmatrix.h"
+
+using namespace std;
+
+template<typename T> class TBandLU;
+
+//   -
+//       -kl  ku.   LAPACK,
+//    :  j  ld = kl + ku + 1
+// , a[i][j]    ku + i - j  .
+//     
+template<typename T>
+class TBandMatrix
+{
+    size_t sz;
+    size_t kl, ku;
+    size_t ld;
+    T* pMem;
+
+    T* col(size_t j) noexcept { return pMem + j * ld; }
+    const T* col(size_t j) const noexcept { return pMem + j * ld; }
+
+    //   j,   : [first_row, last_row)
+    size_t first_row(size_t j) const noexcept { return j > ku ? j - ku : 0; }
+    size_t last_row(size_t j) const noexcept { return std::min(sz, j + kl + 1); }
+
+    bool in_band(size_t i, size_t j) const noexcept { return i + ku >= j && j + kl >= i; }
+
+    // *this += alpha * m,  m    *this
+    void add_scaled(const TBandMatrix& m, const T& alpha)
+    {
+        for (size_t j = 0; j < sz; ++j) {
+            const size_t i0 = m.first_row(j), cnt = m.last_row(j) - i0;
+            TVectorKernels<T>::axpy(alpha, m.col(j) + m.ku + i0 - j, col(j) + ku + i0 - j, cnt);
+        }
+    }
+
+public:
+    TBandMatrix(size_t n = 1, size_t lower = 0, size_t upper = 0) : sz(n), kl(lower), ku(upper)
+    {
+        if (sz == 0)
+            throw out_of_range("Matrix size should be greater than zero");
+        if (sz > MAX_VECTOR_SIZE)
+            throw out_of_range("Matrix size exceeds maximum allowed");
+        if (kl >= sz || ku >= sz)
+            throw out_of_range("Bandwidth must be less than matrix size");
+        ld = kl + ku + 1;
+        pMem = new T[sz * ld]();
+    }
+
+    //   ;    
+    TBandMatrix(const TDynamicMatrix<T>& m, size_t lower, size_t upper) : TBandMatrix(m.size(), lower, upper)
+    {
+        for (size_t j = 0; j < sz; ++j)
+            for (size_t i = first_row(j); i < last_row(j); ++i)
+                col(j)[ku + i - j] = m[i][j];
+    }
+
+    TBandMatrix(const TBandMatrix& m) : sz(m.sz), kl(m.kl), ku(m.ku), ld(m.ld)
+    {
+        pMem = new T[sz * ld];
+        std::copy(m.pMem, m.pMem + sz * ld, pMem);
+    }
+
+    TBandMatrix(TBandMatrix&& m) noexcept : sz(m.sz), kl(m.kl), ku(m.ku), ld(m.ld), pMem(m.pMem)
+    {
+        m.sz = 0;
+        m.pMem = nullptr;
+    }
+
+    ~TBandMatrix()
+    {
+        delete[] pMem;
+        pMem = nullptr;
+        sz = 0;
+    }
+
+    TBandMatrix& operator=(const TBandMatrix& m)
+    {
+        if (this == &m) return *this;
+
+        TBandMatrix tmp(m);
+        swap(*this, tmp);
+        return *this;
+    }
+
+    TBandMatrix& operator=(TBandMatrix&& m) noexcept
+    {
+        if (this == &m) return *this;
+
+        TBandMatrix tmp(std::move(m));
+        swap(*this, tmp);
+        return *this;
+    }
+
+    size_t size() const noexcept { return sz; }
+    size_t lower() const noexcept { return kl; }
+    size_t upper() const noexcept { return ku; }
+
+    //    LAPACK (  ld)
+    T* data() noexcept { return pMem; }
+    const T* data() const noexcept { return pMem; }
+    size_t leading_dimension() const noexcept { return ld; }
+
+    // : (i, j)    
+    T& operator()(size_t i, size_t j)
+    {
+        return col(j)[ku + i - j];
+    }
+
+    const T& operator()(size_t i, size_t j) const
+    {
+        return col(j)[ku + i - j];
+    }
+
+    //   
+    T& at(size_t i, size_t j)
+    {
+        if (i >= sz || j >= sz)
+            throw out_of_range("Index out of range in at()");
+        if (!in_band(i, j))
+            throw out_of_range("Element is outside the band");
+        return (*this)(i, j);
+    }
+
+    //     
+    T get(size_t i, size_t j) const
+    {
+        return in_band(i, j) ? (*this)(i, j) : T();
+    }
+
+    bool operator==(const TBandMatrix& m) const noexcept
+    {
+        return sz == m.sz && kl == m.kl && ku == m.ku && std::equal(pMem, pMem + sz * ld, m.pMem);
+    }
+
+    bool operator!=(const TBandMatrix& m) const noexcept
+    {
+        return !(*this == m);
+    }
+
+    //   :   -   
+    TBandMatrix& operator+=(const TBandMatrix& m)
+    {
+        if (sz != m.sz)
+            throw invalid_argument("Matrix sizes must be equal for addition");
+
+        if (kl == m.kl && ku == m.ku) {
+            TVectorKernels<T>::add(pMem, m.pMem, pMem, sz * ld);
+            return *this;
+        }
+        if (kl < m.kl || ku < m.ku) {
+            TBandMatrix wide(sz, std::max(kl, m.kl), std::max(ku, m.ku));
+            wide.add_scaled(*this, T(1));
+            swap(*this, wide);
+        }
+        add_scaled(m, T(1));
+        return *this;
+    }
+
+    TBandMatrix& operator-=(const TBandMatrix& m)
+    {
+        if (sz != m.sz)
+            throw invalid_argument("Matrix sizes must be equal for subtraction");
+
+        if (kl == m.kl && ku == m.ku) {
+            TVectorKernels<T>::sub(pMem, m.pMem, pMem, sz * ld);
+            return *this;
+        }
+        if (kl < m.kl || ku < m.ku) {
+            TBandMatrix wide(sz, std::max(kl, m.kl), std::max(ku, m.ku));
+            wide.add_scaled(*this, T(1));
+            swap(*this, wide);
+        }
+        add_scaled(m, T(-1));
+        return *this;
+    }
+
+    TBandMatrix& operator*=(const T& val)
+    {
+        TVectorKernels<T>::mul_scalar(pMem, val, pMem, sz * ld);
+        return *this;
+    }
+
+    TBandMatrix operator+(const TBandMatrix& m) const
+    {
+        TBandMatrix result(*this);
+        result += m;
+        return result;
+    }
+
+    TBandMatrix operator-(const TBandMatrix& m) const
+    {
+        TBandMatrix result(*this);
+        result -= m;
+        return result;
+    }
+
+    TBandMatrix operator*(const T& val) const
+    {
+        TBandMatrix result(*this);
+        result *= val;
+        return result;
+    }
+
+    // -   O(n * (kl + ku)):  j
+    //   y  axpy.     
+    //      y       
+    TDynamicVector<T> operator*(const TDynamicVector<T>& v) const
+    {
+        if (sz != v.size())
+            throw invalid_argument("Matrix columns must equal vector size for multiplication");
+
+        TDynamicVector<T> result(sz);
+        const T* x = v.data();
+        T* y = result.data();
+        TThreadPool::parallel_blocks(sz, std::max<size_t>(1, EXPR_GRAIN / ld), [&](size_t begin, size_t end) {
+            const size_t j0 = begin > kl ? begin - kl : 0, j1 = std::min(sz, end + ku);
+            for (size_t j = j0; j < j1; ++j) {
+                const size_t i0 = std::max(begin, first_row(j)), i1 = std::min(end, last_row(j));
+                if (i0 < i1)
+                    TVectorKernels<T>::axpy(x[j], col(j) + ku + i0 - j, y + i0, i1 - i0);
+            }
+        });
+        return result;
+    }
+
+    // LU-      
+    TBandLU<T> factor() const
+    {
+        return TBandLU<T>(*this);
+    }
+
+    //  A x = b;      
+    TDynamicVector<T> solve(const TDynamicVector<T>& b) const
+    {
+        return factor().solve(b);
+    }
+
+    TDynamicMatrix<T> to_dense() const
+    {
+        TDynamicMatrix<T> m(sz);
+        for (size_t j = 0; j < sz; ++j)
+            for (size_t i = first_row(j); i < last_row(j); ++i)
+                m[i][j] = col(j)[ku + i - j];
+        return m;
+    }
+
+    friend void swap(TBandMatrix& lhs, TBandMatrix& rhs) noexcept
+    {
+        std::swap(lhs.sz, rhs.sz);
+        std::swap(lhs.kl, rhs.kl);
+        std::swap(lhs.ku, rhs.ku);
+        std::swap(lhs.ld, rhs.ld);
+        std::swap(lhs.pMem, rhs.pMem);
+    }
+
+    friend ostream& operator<<(ostream& ostr, const TBandMatrix& m)
+    {
+        ostr << "Band matrix " << m.sz << "x" << m.sz << " (" << m.kl << ", " << m.ku << "):\n";
+        for (size_t i = 0; i < m.sz; ++i) {
+            ostr << "  [ ";
+            for (size_t j = 0; j < m.sz; ++j) {
+                ostr << setw(6) << m.get(i, j);
+            }
+            ostr << " ]\n";
+        }
+        return ostr;
+    }
+};
+
+
+//  LU- ( LAPACK gbtrf/gbtrs) -
+// P A = L U;      U  kl + ku,
+//    ld = 2 * kl + ku + 1 .  
+//    O(n * kl * (kl + ku))  O(n * (2 * kl + ku))
+template<typename T>
+class TBandLU
+{
+    size_t sz;
+    size_t kl, kv;
+    size_t ld;
+    vector<T> ab;
+    vector<size_t> pivot;
+
+    // a[i][j]   kv + i - j  j
+    T& at(size_t i, size_t j) noexcept { return ab[j * ld + kv + i - j]; }
+
+    static double magnitude(const T& x) { using std::abs; return double(abs(x)); }
+
+public:
+    explicit TBandLU(const TBandMatrix<T>& a)
+        : sz(a.size()), kl(a.lower()), kv(a.lower() + a.upper()), ld(2 * a.lower() + a.upper() + 1),
+          ab(sz * ld), pivot(sz)
+    {
+        const size_t ku = a.upper();
+        for (size_t j = 0; j < sz; ++j) {
+            const size_t i0 = j > ku ? j - ku : 0, i1 = std::min(sz, j + kl + 1);
+            for (size_t i = i0; i < i1; ++i)
+                at(i, j) = a(i, j);
+        }
+
+        size_t ju = 0;
+        for (size_t j = 0; j < sz; ++j) {
+            const size_t km = std::min(kl, sz - 1 - j);
+            size_t jp = 0;
+            for (size_t p = 1; p <= km; ++p)
+                if (magnitude(at(j + p, j)) > magnitude(at(j + jp, j)))
+                    jp = p;
+            pivot[j] = j + jp;
+            if (at(j + jp, j) == T())
+                throw invalid_argument("Band matrix is singular");
+
+            ju = std::max(ju, std::min(j + kv - kl + jp, sz - 1));
+            if (jp != 0)
+                for (size_t c = j; c <= ju; ++c)
+                    std::swap(at(j, c), at(j + jp, c));
+            if (km == 0)
+                continue;
+
+            const T d = at(j, j);
+            T* l = &at(j + 1, j);
+            for (size_t p = 0; p < km; ++p)
+                l[p] /= d;
+            //   1:  j+1..ju,  j+1..j+km  
+            for (size_t c = j + 1; c <= ju; ++c)
+                TVectorKernels<T>::axpy(-at(j, c), l, &at(j + 1, c), km);
+        }
+    }
+
+    size_t size() const noexcept { return sz; }
+
+    //   : b   x,   
+    void solve_in_place(TDynamicVector<T>& b) const
+    {
+        if (b.size() != sz)
+            throw invalid_argument("Vector size must equal matrix size for solve");
+
+        T* x = b.data();
+        // L y = P b
+        for (size_t j = 0; j + 1 < sz; ++j) {
+            if (pivot[j] != j)
+                std::swap(x[j], x[pivot[j]]);
+            const size_t lm = std::min(kl, sz - 1 - j);
+            TVectorKernels<T>::axpy(-x[j], &ab[j * ld + kv + 1], x + j + 1, lm);
+        }
+        // U x = y,    
+        for (size_t j = sz; j-- > 0;) {
+            x[j] /= ab[j * ld + kv];
+            const size_t cnt = std::min(j, kv);
+            TVectorKernels<T>::axpy(-x[j], &ab[j * ld + kv - cnt], x + j - cnt, cnt);
+        }
+    }
+
+    TDynamicVector<T> solve(const TDynamicVector<T>& b) const
+    {
+        TDynamicVector<T> x(b);
+        solve_in_place(x);
+        return x;
+    }
+};
+
+#endif
@@ -0,0 +1,337 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//      ( BSR)
+
+#ifndef __TBsr_H__
+#define __TBsr_H__
+
+#include <algorithm>
+#include <numeric>
+
+#include "tsparse.h"
+
+using namespace std;
+
+//  ,    
+struct TBlockSize
+{
+    size_t rows, cols;
+};
+
+//    r x c   ;   
+//    r  c.         
+template<typename T>
+size_t bsr_block_count(const TSparseMatrixCSR<T>& a, size_t r, size_t c)
+{
+    if (r == 0 || c == 0 || a.rows() % r != 0 || a.cols() % c != 0)
+        throw invalid_argument("Block size must divide matrix dimensions");
+
+    const vector<size_t>& rp = a.row_ptr();
+    const auto& ci = a.col_idx();
+    vector<size_t> mark(a.cols() / c, size_t(-1));
+    size_t blocks = 0;
+    for (size_t br = 0; br < a.rows() / r; ++br)
+        for (size_t k = rp[br * r]; k < rp[(br + 1) * r]; ++k) {
+            const size_t bc = ci[k] / c;
+            if (mark[bc] != br) {
+                mark[bc] = br;
+                ++blocks;
+            }
+        }
+    return blocks;
+}
+
+//   -
+//    max_block,   ,  
+//    :        .
+//   (3 x 3   )   
+//        ,   -   
+template<typename T>
+TBlockSize bsr_detect_block(const TSparseMatrixCSR<T>& a, size_t max_block = 4)
+{
+    TBlockSize best = { 1, 1 };
+    size_t best_bytes = a.nnz() * (sizeof(T) + sizeof(uint32_t));
+    for (size_t r = 1; r <= max_block; ++r)
+        for (size_t c = 1; c <= max_block; ++c) {
+            if (a.rows() % r != 0 || a.cols() % c != 0)
+                continue;
+            const size_t bytes = bsr_block_count(a, r, c) * (r * c * sizeof(T) + sizeof(uint32_t));
+            if (bytes < best_bytes) {
+                best_bytes = bytes;
+                best = { r, c };
+            }
+        }
+    return best;
+}
+
+//    -
+//      R x C;   br 
+//  [block_ptr[br], block_ptr[br + 1])   
+//  ,   - R * C   .
+//       R * C,    
+//         x  
+template<typename T, size_t R, size_t C>
+class TSparseMatrixBSR
+{
+    static_assert(R > 0 && C > 0, "Block size must be positive");
+
+public:
+    using index_type = uint32_t;
+    using value_type = T;
+    static constexpr size_t BLOCK = R * C;
+
+private:
+    size_t nrows, ncols;
+    vector<size_t> blockPtr;
+    vector<index_type> blockCol;
+    vector<T> vals;
+
+    size_t block_rows() const noexcept { return nrows / R; }
+
+    // y[R] =    br  x
+    void multiply_block_rows(size_t begin, size_t end, const T* x, T* y) const
+    {
+        for (size_t br = begin; br < end; ++br) {
+            T sum[R] = {};
+            for (size_t b = blockPtr[br]; b < blockPtr[br + 1]; ++b) {
+                const T* v = vals.data() + b * BLOCK;
+                const T* xb = x + size_t(blockCol[b]) * C;
+#pragma GCC unroll 8
+                for (size_t r = 0; r < R; ++r)
+#pragma GCC unroll 8
+                    for (size_t c = 0; c < C; ++c)
+                        sum[r] += v[r * C + c] * xb[c];
+            }
+            std::copy(sum, sum + R, y + br * R);
+        }
+    }
+
+    // Y[R x k] =    br  X[C x k],  X  Y  
+    // ldx  ldy.     j:    
+    //  X      Y ,  
+    void multiply_block_rows(size_t begin, size_t end, const T* x, size_t ldx, T* y, size_t ldy, size_t k) const
+    {
+        for (size_t br = begin; br < end; ++br) {
+            T* yb = y + br * R * ldy;
+            for (size_t r = 0; r < R; ++r)
+                std::fill(yb + r * ldy, yb + r * ldy + k, T());
+            for (size_t b = blockPtr[br]; b < blockPtr[br + 1]; ++b) {
+                const T* v = vals.data() + b * BLOCK;
+                const T* xb = x + size_t(blockCol[b]) * C * ldx;
+#pragma GCC unroll 8
+                for (size_t r = 0; r < R; ++r) {
+                    T* yr = yb + r * ldy;
+#pragma GCC unroll 8
+                    for (size_t c = 0; c < C; ++c) {
+                        const T a = v[r * C + c];
+                        const T* xr = xb + c * ldx;
+                        for (size_t j = 0; j < k; ++j)
+                            yr[j] += a * xr[j];
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename F>
+    void for_block_rows(F body) const
+    {
+        const size_t parts = csr_parts(vals.size());
+        if (parts == 1) {
+            body(0, block_rows());
+            return;
+        }
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            body(csr_bound(blockPtr, parts, t), csr_bound(blockPtr, parts, t + 1));
+        });
+    }
+
+public:
+    static constexpr size_t block_height() noexcept { return R; }
+    static constexpr size_t block_width() noexcept { return C; }
+
+    TSparseMatrixBSR(size_t rows = R, size_t cols = C) : nrows(rows), ncols(cols), blockPtr(rows / R + 1, 0)
+    {
+        if (rows == 0 || cols == 0 || rows % R != 0 || cols % C != 0)
+            throw invalid_argument("Matrix dimensions must be positive multiples of the block size");
+        if (rows > MAX_VECTOR_SIZE || cols > MAX_VECTOR_SIZE)
+            throw out_of_range("Matrix size exceeds maximum allowed");
+    }
+
+    // ,   CSR;    - .
+    //       ,   
+    explicit TSparseMatrixBSR(const TSparseMatrixCSR<T>& a) : TSparseMatrixBSR(a.rows(), a.cols())
+    {
+        const vector<size_t>& rp = a.row_ptr();
+        const auto& ci = a.col_idx();
+        const auto& va = a.values();
+        const size_t grain = std::max<size_t>(1, SPARSE_GRAIN / std::max<size_t>(1, a.nnz() / block_rows()));
+
+        //    br  ,  
+        auto block_cols = [&](size_t br, vector<index_type>& out) {
+            out.clear();
+            for (size_t k = rp[br * R]; k < rp[(br + 1) * R]; ++k)
+                out.push_back(index_type(ci[k] / C));
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        };
+
+        TThreadPool::parallel_blocks(block_rows(), grain, [&](size_t begin, size_t end) {
+            vector<index_type> cols;
+            for (size_t br = begin; br < end; ++br) {
+                block_cols(br, cols);
+                blockPtr[br + 1] = cols.size();
+            }
+        });
+        std::partial_sum(blockPtr.begin(), blockPtr.end(), blockPtr.begin());
+        blockCol.resize(blockPtr.back());
+        vals.assign(blockPtr.back() * BLOCK, T());
+        TThreadPool::parallel_blocks(block_rows(), grain, [&](size_t begin, size_t end) {
+            vector<index_type> cols;
+            for (size_t br = begin; br < end; ++br) {
+                block_cols(br, cols);
+                std::copy(cols.begin(), cols.end(), blockCol.begin() + blockPtr[br]);
+                for (size_t r = 0; r < R; ++r) {
+                    const size_t i = br * R + r;
+                    //  CSR ,     
+                    size_t b = blockPtr[br];
+                    for (size_t k = rp[i]; k < rp[i + 1]; ++k) {
+                        while (blockCol[b] != ci[k] / C)
+                            ++b;
+                        vals[b * BLOCK + r * C + ci[k] % C] = va[k];
+                    }
+                }
+            }
+        });
+    }
+
+    size_t rows() const noexcept { return nrows; }
+    size_t cols() const noexcept { return ncols; }
+    size_t blocks() const noexcept { return blockCol.size(); }
+
+    const vector<size_t>& block_ptr() const noexcept { return blockPtr; }
+    const vector<index_type>& block_col() const noexcept { return blockCol; }
+    const vector<T>& values() const noexcept { return vals; }
+
+    //  (i, j)  ;     
+    T get(size_t i, size_t j) const
+    {
+        if (i >= nrows || j >= ncols)
+            throw out_of_range("Index out of range in get()");
+        const size_t br = i / R;
+        const auto first = blockCol.begin() + blockPtr[br], last = blockCol.begin() + blockPtr[br + 1];
+        const auto it = std::lower_bound(first, last, index_type(j / C));
+        if (it == last || *it != j / C)
+            return T();
+        return vals[size_t(it - blockCol.begin()) * BLOCK + i % R * C + j % C];
+    }
+
+    bool operator==(const TSparseMatrixBSR& m) const
+    {
+        return nrows == m.nrows && ncols == m.ncols && blockPtr == m.blockPtr && blockCol == m.blockCol && vals == m.vals;
+    }
+
+    bool operator!=(const TSparseMatrixBSR& m) const
+    {
+        return !(*this == m);
+    }
+
+    //   CSR;     
+    TSparseMatrixCSR<T> to_csr() const
+    {
+        vector<size_t> rp(nrows + 1, 0);
+        vector<index_type> ci;
+        vector<T> va;
+        for (size_t i = 0; i < nrows; ++i) {
+            const size_t br = i / R, r = i % R;
+            for (size_t b = blockPtr[br]; b < blockPtr[br + 1]; ++b)
+                for (size_t c = 0; c < C; ++c) {
+                    const T& v = vals[b * BLOCK + r * C + c];
+                    if (v != T()) {
+                        ci.push_back(index_type(blockCol[b] * C + c));
+                        va.push_back(v);
+                    }
+                }
+            rp[i + 1] = ci.size();
+        }
+        return TSparseMatrixCSR<T>(nrows, ncols, std::move(rp), std::move(ci), std::move(va));
+    }
+
+    // y = A x;        
+    void multiply(const TDynamicVector<T>& x, TDynamicVector<T>& y) const
+    {
+        if (x.size() != ncols || y.size() != nrows)
+            throw invalid_argument("Vector sizes must match matrix for multiplication");
+        if (&x == &y)
+            throw invalid_argument("Output vector must not alias the input");
+
+        const T* px = x.data();
+        T* py = y.data();
+        for_block_rows([&](size_t begin, size_t end) { multiply_block_rows(begin, end, px, py); });
+    }
+
+    TDynamicVector<T> operator*(const TDynamicVector<T>& x) const
+    {
+        TDynamicVector<T> y(nrows);
+        multiply(x, y);
+        return y;
+    }
+
+    // Y = A X  k  : X (cols x k)  Y (rows x k) 
+    //     ldx  ldy,     k
+    //    X
+    void multiply(const T* x, size_t ldx, T* y, size_t ldy, size_t k) const
+    {
+        if (k == 0)
+            return;
+        spmm_check_blocks(x, ncols, ldx, y, nrows, ldy, k);
+        for_block_rows([&](size_t begin, size_t end) { multiply_block_rows(begin, end, x, ldx, y, ldy, k); });
+    }
+
+    //  A   X:   x.size() 
+    void multiply(const TDynamicMatrix<T>& x, TDynamicMatrix<T>& y) const
+    {
+        if (nrows != ncols || x.size() != ncols || y.size() != nrows)
+            throw invalid_argument("Matrix sizes must match for multiplication");
+        multiply(x.data(), x.ld(), y.data(), y.ld(), x.size());
+    }
+
+    TDynamicMatrix<T> operator*(const TDynamicMatrix<T>& x) const
+    {
+        TDynamicMatrix<T> y(nrows);
+        multiply(x, y);
+        return y;
+    }
+};
+
+//  ,     TSparseMatrixBSR
+//  bsr_visit
+constexpr size_t BSR_MAX_BLOCK = 4;
+
+template<size_t R, size_t C, typename T, typename F>
+auto bsr_visit_block(const TSparseMatrixCSR<T>& a, TBlockSize bs, F& f) -> decltype(f(TSparseMatrixBSR<T, 1, 1>(a)))
+{
+    if (bs.rows == R && bs.cols == C)
+        return f(TSparseMatrixBSR<T, R, C>(a));
+    if constexpr (C < BSR_MAX_BLOCK)
+        return bsr_visit_block<R, C + 1>(a, bs, f);
+    else if constexpr (R < BSR_MAX_BLOCK)
+        return bsr_visit_block<R + 1, 1>(a, bs, f);
+    else
+        throw invalid_argument("Block size exceeds BSR_MAX_BLOCK");
+}
+
+//  CSR -> BSR    -
+//   -  ,  , 
+// bsr_detect_block   ,    
+//  BSR_MAX_BLOCK x BSR_MAX_BLOCK,  f   :
+// bsr_visit(a, [&](const auto& b) { y = b * x; })
+template<typename T, typename F>
+auto bsr_visit(const TSparseMatrixCSR<T>& a, F f, size_t max_block = BSR_MAX_BLOCK)
+{
+    return bsr_visit_block<1, 1>(a, bsr_detect_block(a, std::min(max_block, BSR_MAX_BLOCK)), f);
+}
+
+#endif
@@ -0,0 +1,64 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//        
+
+#ifndef __TCpu_H__
+#define __TCpu_H__
+
+#include <algorithm>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TMATRIX_X86 1
+#include <immintrin.h>
+//         -mavx2/-mavx512f,
+//        Haswell,   Skylake-SP
+#define TMATRIX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TMATRIX_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx2,fma")))
+#endif
+
+enum class TCpuLevel { Scalar = 0, AVX2 = 1, AVX512 = 2 };
+
+//   -
+//      cpuid     
+class TCpu
+{
+    static TCpuLevel detect() noexcept
+    {
+#ifdef TMATRIX_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+            return TCpuLevel::AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return TCpuLevel::AVX2;
+#endif
+        return TCpuLevel::Scalar;
+    }
+
+    static TCpuLevel& cap() noexcept
+    {
+        static TCpuLevel c = TCpuLevel::AVX512;
+        return c;
+    }
+
+public:
+    static TCpuLevel detected() noexcept
+    {
+        static const TCpuLevel level = detect();
+        return level;
+    }
+
+    static TCpuLevel level() noexcept
+    {
+        return std::min(detected(), cap());
+    }
+
+    //   (    )
+    static void limit(TCpuLevel max_level) noexcept
+    {
+        cap() = max_level;
+    }
+};
+
+#endif
@@ -0,0 +1,318 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//  :       
+
+#ifndef __TExpr_H__
+#define __TExpr_H__
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "tsimd.h"
+#include "tthreadpool.h"
+
+using namespace std;
+
+template<typename T> class TDynamicVector;
+
+//  -
+//   (CRTP)     .
+//  E :
+//   container, value_type    -     ;
+//   size()                   -  (  -);
+//   expr_length()            -      ;
+//   expr_direct(first)       -      nullptr;
+//   expr_eval(first, n, out) -  n    first;
+//   expr_references(p)       -     p
+template<typename E>
+class TExpr
+{
+public:
+    const E& self() const noexcept { return static_cast<const E&>(*this); }
+};
+
+//      ,  -  
+template<typename E>
+using TExprOperand = typename conditional<E::is_leaf, const E&, const E>::type;
+
+//   ,   L1:  
+//   ,      
+constexpr size_t EXPR_CHUNK = 256;
+
+//      :
+//       EXPR_GRAIN 
+constexpr size_t EXPR_GRAIN = 64 * EXPR_CHUNK;
+
+//  -
+//          
+template<typename T>
+struct TExprAdd
+{
+    static void binary(const T* a, const T* b, T* r, size_t n) { TVectorKernels<T>::add(a, b, r, n); }
+    static void scalar(const T* a, T val, T* r, size_t n) { TVectorKernels<T>::add_scalar(a, val, r, n); }
+};
+
+template<typename T>
+struct TExprSub
+{
+    static void binary(const T* a, const T* b, T* r, size_t n) { TVectorKernels<T>::sub(a, b, r, n); }
+    static void scalar(const T* a, T val, T* r, size_t n) { TVectorKernels<T>::sub_scalar(a, val, r, n); }
+};
+
+template<typename T>
+struct TExprMul
+{
+    static void binary(const T* a, const T* b, T* r, size_t n) { TVectorKernels<T>::mul(a, b, r, n); }
+    static void scalar(const T* a, T val, T* r, size_t n) { TVectorKernels<T>::mul_scalar(a, val, r, n); }
+};
+
+
+//  " op "
+template<typename L, typename R, template<typename> class Op>
+class TExprBinary : public TExpr<TExprBinary<L, R, Op>>
+{
+    TExprOperand<L> lhs;
+    TExprOperand<R> rhs;
+public:
+    using container = typename L::container;
+    using value_type = typename L::value_type;
+    static constexpr bool is_leaf = false;
+
+    TExprBinary(const L& l, const R& r) : lhs(l), rhs(r)
+    {
+        if (lhs.size() != rhs.size())
+            throw invalid_argument("Operand sizes must be equal");
+    }
+
+    size_t size() const noexcept { return lhs.size(); }
+    size_t expr_length() const noexcept { return lhs.expr_length(); }
+    const value_type* expr_direct(size_t) const noexcept { return nullptr; }
+
+    bool expr_references(const void* p) const noexcept
+    {
+        return lhs.expr_references(p) || rhs.expr_references(p);
+    }
+
+    void expr_eval(size_t first, size_t n, value_type* out) const
+    {
+        const value_type* l = lhs.expr_direct(first);
+        const value_type* r = rhs.expr_direct(first);
+        value_type tmp[EXPR_CHUNK];
+        if (l == nullptr && r == nullptr) {
+            lhs.expr_eval(first, n, out);
+            rhs.expr_eval(first, n, tmp);
+            l = out;
+            r = tmp;
+        }
+        else if (l == nullptr) {
+            lhs.expr_eval(first, n, out);
+            l = out;
+        }
+        else if (r == nullptr) {
+            rhs.expr_eval(first, n, out);
+            r = out;
+        }
+        Op<value_type>::binary(l, r, out, n);
+    }
+};
+
+//  " op "
+template<typename E, template<typename> class Op>
+class TExprScalar : public TExpr<TExprScalar<E, Op>>
+{
+public:
+    using container = typename E::container;
+    using value_type = typename E::value_type;
+    static constexpr bool is_leaf = false;
+
+    TExprScalar(const E& e, const value_type& v) : arg(e), val(v) {}
+
+    size_t size() const noexcept { return arg.size(); }
+    size_t expr_length() const noexcept { return arg.expr_length(); }
+    const value_type* expr_direct(size_t) const noexcept { return nullptr; }
+
+    bool expr_references(const void* p) const noexcept
+    {
+        return arg.expr_references(p);
+    }
+
+    void expr_eval(size_t first, size_t n, value_type* out) const
+    {
+        const value_type* a = arg.expr_direct(first);
+        if (a == nullptr) {
+            arg.expr_eval(first, n, out);
+            a = out;
+        }
+        Op<value_type>::scalar(a, val, out, n);
+    }
+
+private:
+    TExprOperand<E> arg;
+    value_type val;
+};
+
+
+//      out.
+//     ,    
+// (a = b * 2 + a),      .
+//          
+// ,        
+template<typename E>
+void expr_assign(const E& e, typename E::value_type* out, bool aliased)
+{
+    using T = typename E::value_type;
+    TThreadPool::parallel_blocks(e.expr_length(), EXPR_GRAIN, [&](size_t begin, size_t end) {
+        T tmp[EXPR_CHUNK];
+        for (size_t first = begin; first < end; first += EXPR_CHUNK) {
+            const size_t n = std::min(EXPR_CHUNK, end - first);
+            if (aliased) {
+                e.expr_eval(first, n, tmp);
+                std::copy(tmp, tmp + n, out + first);
+            }
+            else {
+                e.expr_eval(first, n, out + first);
+            }
+        }
+    });
+}
+
+//   out op= e.
+//        
+//      ;   
+template<template<typename> class Op, typename E>
+void expr_compound(const E& e, typename E::value_type* out)
+{
+    using T = typename E::value_type;
+    TThreadPool::parallel_blocks(e.expr_length(), EXPR_GRAIN, [&](size_t begin, size_t end) {
+        T tmp[EXPR_CHUNK];
+        for (size_t first = begin; first < end; first += EXPR_CHUNK) {
+            const size_t n = std::min(EXPR_CHUNK, end - first);
+            const T* x = e.expr_direct(first);
+            if (x == nullptr) {
+                e.expr_eval(first, n, tmp);
+                x = tmp;
+            }
+            Op<T>::binary(out + first, x, out + first, n);
+        }
+    });
+}
+
+template<typename L, typename R>
+using TExprSameKind = typename enable_if<is_same<typename L::container, typename R::container>::value>::type;
+
+template<typename E>
+using TExprVectorKind = typename enable_if<is_same<typename E::container,
+    TDynamicVector<typename E::value_type>>::value>::type;
+
+
+//   
+template<typename L, typename R, typename = TExprSameKind<L, R>>
+TExprBinary<L, R, TExprAdd> operator+(const TExpr<L>& l, const TExpr<R>& r)
+{
+    return TExprBinary<L, R, TExprAdd>(l.self(), r.self());
+}
+
+template<typename L, typename R, typename = TExprSameKind<L, R>>
+TExprBinary<L, R, TExprSub> operator-(const TExpr<L>& l, const TExpr<R>& r)
+{
+    return TExprBinary<L, R, TExprSub>(l.self(), r.self());
+}
+
+//   ( )
+template<typename L, typename R, typename = TExprSameKind<L, R>>
+TExprBinary<L, R, TExprMul> hadamard(const TExpr<L>& l, const TExpr<R>& r)
+{
+    return TExprBinary<L, R, TExprMul>(l.self(), r.self());
+}
+
+template<typename E>
+TExprScalar<E, TExprMul> operator*(const TExpr<E>& e, const typename E::value_type& val)
+{
+    return TExprScalar<E, TExprMul>(e.self(), val);
+}
+
+template<typename E>
+TExprScalar<E, TExprMul> operator*(const typename E::value_type& val, const TExpr<E>& e)
+{
+    return TExprScalar<E, TExprMul>(e.self(), val);
+}
+
+//      :  
+//     ,     
+template<typename L, typename R, typename = typename enable_if<!L::is_leaf>::type>
+auto operator*(const TExpr<L>& l, const TExpr<R>& r)
+    -> decltype(declval<const typename L::container&>() * r.self())
+{
+    return typename L::container(l.self()) * r.self();
+}
+
+//    -
+//         
+// ; -    ( 
+// ,      operator== )
+template<typename L, typename R>
+using TExprCompare = typename enable_if<is_same<typename L::container, typename R::container>::value &&
+    !(L::is_leaf && R::is_leaf)>::type;
+
+template<typename E>
+const E& expr_value(const E& e, true_type) noexcept
+{
+    return e;
+}
+
+template<typename E>
+typename E::container expr_value(const E& e, false_type)
+{
+    return typename E::container(e);
+}
+
+template<typename L, typename R>
+bool expr_equal(const L& l, const R& r)
+{
+    const auto& a = expr_value(l, integral_constant<bool, L::is_leaf>());
+    const auto& b = expr_value(r, integral_constant<bool, R::is_leaf>());
+    return a == b;
+}
+
+template<typename L, typename R, typename = TExprCompare<L, R>, typename = typename enable_if<!L::is_leaf>::type>
+bool operator==(const TExpr<L>& l, const TExpr<R>& r)
+{
+    return expr_equal(l.self(), r.self());
+}
+
+template<typename C, typename R, typename = TExprCompare<C, R>, typename = typename enable_if<C::is_leaf>::type>
+bool operator==(const C& l, const TExpr<R>& r)
+{
+    return expr_equal(l, r.self());
+}
+
+template<typename L, typename R, typename = TExprCompare<L, R>, typename = typename enable_if<!L::is_leaf>::type>
+bool operator!=(const TExpr<L>& l, const TExpr<R>& r)
+{
+    return !expr_equal(l.self(), r.self());
+}
+
+template<typename C, typename R, typename = TExprCompare<C, R>, typename = typename enable_if<C::is_leaf>::type>
+bool operator!=(const C& l, const TExpr<R>& r)
+{
+    return !expr_equal(l, r.self());
+}
+
+//       
+template<typename E, typename = TExprVectorKind<E>>
+TExprScalar<E, TExprAdd> operator+(const TExpr<E>& e, const typename E::value_type& val)
+{
+    return TExprScalar<E, TExprAdd>(e.self(), val);
+}
+
+template<typename E, typename = TExprVectorKind<E>>
+TExprScalar<E, TExprSub> operator-(const TExpr<E>& e, const typename E::value_type& val)
+{
+    return TExprScalar<E, TExprSub>(e.self(), val);
+}
+
+#endif
@@ -0,0 +1,383 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//    (GEMM)   
+
+#ifndef __TGemm_H__
+#define __TGemm_H__
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <new>
+
+#include "tsimd.h"
+#include "tthreadpool.h"
+
+using namespace std;
+
+//   -
+//      
+template<typename T>
+class TAlignedBuffer
+{
+    static constexpr size_t ALIGNMENT = 64;
+
+    size_t cap;
+    T* pMem;
+public:
+    TAlignedBuffer() noexcept : cap(0), pMem(nullptr) {}
+    TAlignedBuffer(const TAlignedBuffer&) = delete;
+    TAlignedBuffer& operator=(const TAlignedBuffer&) = delete;
+
+    ~TAlignedBuffer()
+    {
+        release();
+    }
+
+    //   ,    
+    T* reserve(size_t count)
+    {
+        if (count > cap) {
+            release();
+            T* p = static_cast<T*>(::operator new(count * sizeof(T), align_val_t(ALIGNMENT)));
+            try {
+                std::uninitialized_value_construct_n(p, count);
+            }
+            catch (...) {
+                ::operator delete(p, align_val_t(ALIGNMENT));
+                throw;
+            }
+            pMem = p;
+            cap = count;
+        }
+        return pMem;
+    }
+
+    T* data() const noexcept { return pMem; }
+    size_t capacity() const noexcept { return cap; }
+
+private:
+    void release() noexcept
+    {
+        if (pMem != nullptr) {
+            std::destroy_n(pMem, cap);
+            ::operator delete(pMem, align_val_t(ALIGNMENT));
+            pMem = nullptr;
+        }
+        cap = 0;
+    }
+};
+
+
+//  GEMM -
+//   mr x nr: C = alpha * A * B + beta * C   
+// A  B;  beta == 0   C  
+template<typename T>
+struct TGemmKernel
+{
+    using ukernel_t = void (*)(size_t kc, const T* a, const T* b, T* c, size_t ldc, T alpha, T beta);
+
+    size_t mr;
+    size_t nr;
+    ukernel_t ukernel;
+    const char* name;
+};
+
+//    
+template<typename T, size_t MR, size_t NR>
+void gemm_ukernel_ref(size_t kc, const T* a, const T* b, T* c, size_t ldc, T alpha, T beta)
+{
+    T ab[MR][NR] = {};
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t i = 0; i < MR; ++i) {
+            const T ai = a[i];
+            for (size_t j = 0; j < NR; ++j)
+                ab[i][j] += ai * b[j];
+        }
+        a += MR;
+        b += NR;
+    }
+    for (size_t i = 0; i < MR; ++i)
+        for (size_t j = 0; j < NR; ++j)
+            c[i * ldc + j] = beta == T() ? alpha * ab[i][j] : alpha * ab[i][j] + beta * c[i * ldc + j];
+}
+
+#ifdef TMATRIX_X86
+//   -
+//  MR x (NV * W)    -,
+//     k: NV  B, MR  A  MR * NV FMA
+template<typename V, size_t MR, size_t NV>
+struct TGemmMicroKernel
+{
+    using T = typename V::elem;
+    using vec = typename V::vec;
+
+    static void run(size_t kc, const T* a, const T* b, T* c, size_t ldc, T alpha, T beta)
+    {
+        vec acc[MR][NV];
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i)
+#pragma GCC unroll 4
+            for (size_t j = 0; j < NV; ++j)
+                V::zero(acc[i][j]);
+        for (size_t p = 0; p < kc; ++p) {
+            vec bv[NV];
+#pragma GCC unroll 4
+            for (size_t j = 0; j < NV; ++j)
+                V::load(bv[j], b + j * V::W);
+#pragma GCC unroll 16
+            for (size_t i = 0; i < MR; ++i) {
+                vec ai;
+                V::set1(ai, a[i]);
+#pragma GCC unroll 4
+                for (size_t j = 0; j < NV; ++j)
+                    V::fmadd(acc[i][j], ai, bv[j]);
+            }
+            a += MR;
+            b += NV * V::W;
+        }
+        // :      ,
+        //     C
+        vec va, vb;
+        V::set1(va, alpha);
+        V::set1(vb, beta);
+        const bool overwrite = beta == T();
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i)
+#pragma GCC unroll 4
+            for (size_t j = 0; j < NV; ++j) {
+                T* cij = c + i * ldc + j * V::W;
+                vec cv;
+                if (overwrite) {
+                    V::mul(cv, acc[i][j], va);
+                }
+                else {
+                    V::load(cv, cij);
+                    V::mul(cv, cv, vb);
+                    V::fmadd(cv, acc[i][j], va);
+                }
+                V::store(cij, cv);
+            }
+    }
+};
+
+template<typename V, size_t MR, size_t NV>
+TMATRIX_TARGET_AVX2 TMATRIX_FLATTEN void gemm_ukernel_avx2(size_t kc, const typename V::elem* a,
+    const typename V::elem* b, typename V::elem* c, size_t ldc, typename V::elem alpha, typename V::elem beta)
+{
+    TGemmMicroKernel<V, MR, NV>::run(kc, a, b, c, ldc, alpha, beta);
+}
+
+template<typename V, size_t MR, size_t NV>
+TMATRIX_TARGET_AVX512 TMATRIX_FLATTEN void gemm_ukernel_avx512(size_t kc, const typename V::elem* a,
+    const typename V::elem* b, typename V::elem* c, size_t ldc, typename V::elem alpha, typename V::elem beta)
+{
+    TGemmMicroKernel<V, MR, NV>::run(kc, a, b, c, ldc, alpha, beta);
+}
+#endif
+
+//   -
+//   T    ,  double, float
+//  int        
+template<typename T>
+struct TGemmKernels
+{
+    static const TGemmKernel<T>& select() noexcept
+    {
+        static const TGemmKernel<T> ref = { 4, 8, &gemm_ukernel_ref<T, 4, 8>, "scalar" };
+        return ref;
+    }
+};
+
+#ifdef TMATRIX_X86
+// AVX2: 16  ymm,   12 -  (6 x 2),
+// AVX-512: 32  zmm,   24 -  (8 x 3)
+template<typename V2, typename V512>
+struct TGemmKernelsX86
+{
+    using T = typename V2::elem;
+
+    static const TGemmKernel<T>& select() noexcept
+    {
+        static const TGemmKernel<T> ref = { 4, 8, &gemm_ukernel_ref<T, 4, 8>, "scalar" };
+        static const TGemmKernel<T> avx2 = { 6, 2 * V2::W, &gemm_ukernel_avx2<V2, 6, 2>, "avx2" };
+        static const TGemmKernel<T> avx512 = { 8, 3 * V512::W, &gemm_ukernel_avx512<V512, 8, 3>, "avx512" };
+        switch (TCpu::level()) {
+        case TCpuLevel::AVX512: return avx512;
+        case TCpuLevel::AVX2: return avx2;
+        default: return ref;
+        }
+    }
+};
+
+template<> struct TGemmKernels<double> : TGemmKernelsX86<TAvx2Double, TAvx512Double> {};
+template<> struct TGemmKernels<float> : TGemmKernelsX86<TAvx2Float, TAvx512Float> {};
+template<> struct TGemmKernels<int> : TGemmKernelsX86<TAvx2Int, TAvx512Int> {};
+#endif
+
+
+//   -
+// C(m x n) = alpha * A(m x k) * B(k x n) + beta * C,     .
+//     :  B (kc x nc)   L3,
+//  A (mc x kc) -  L2,  B (kc x nr) -  L1
+template<typename T>
+class TGemm
+{
+public:
+    static constexpr size_t L1_BYTES = 32 * 1024;
+    static constexpr size_t L2_BYTES = 256 * 1024;
+    static constexpr size_t L3_BYTES = 4 * 1024 * 1024;
+
+    //      
+    static constexpr size_t BLOCKED_THRESHOLD = 64;
+
+    //    mr * nr
+    static constexpr size_t MAX_TILE = 512;
+
+    //    -     
+    static constexpr size_t PARALLEL_FLOPS = size_t(1) << 21;
+
+    static const TGemmKernel<T>& kernel() noexcept
+    {
+        return TGemmKernels<T>::select();
+    }
+
+    // C += A * B
+    static void multiply(size_t m, size_t n, size_t k,
+                         const T* A, size_t lda, const T* B, size_t ldb, T* C, size_t ldc)
+    {
+        gemm(m, n, k, T(1), A, lda, B, ldb, T(1), C, ldc);
+    }
+
+    // beta       k,  
+    //   beta = 1;  beta == 0 C    
+    static void gemm(size_t m, size_t n, size_t k, T alpha,
+                     const T* A, size_t lda, const T* B, size_t ldb, T beta, T* C, size_t ldc)
+    {
+        if (k == 0) {
+            for (size_t i = 0; i < m; ++i) {
+                T* c = C + i * ldc;
+                if (beta == T())
+                    std::fill(c, c + n, T());
+                else
+                    TVectorKernels<T>::mul_scalar(c, beta, c, n);
+            }
+            return;
+        }
+
+        const TGemmKernel<T>& ker = kernel();
+        const size_t threads = TThreadPool::threads();
+        if (threads <= 1 || m * n * k < PARALLEL_FLOPS) {
+            gemm_serial(ker, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+            return;
+        }
+
+        // C     (   ), 
+        //      
+        const size_t tiles = 4 * threads;
+        size_t rows = std::max<size_t>(1, size_t(sqrt(double(tiles) * m / n) + 0.5));
+        rows = std::min(rows, (m + ker.mr - 1) / ker.mr);
+        size_t cols = std::min((tiles + rows - 1) / rows, (n + ker.nr - 1) / ker.nr);
+        const size_t tm = ((m + rows - 1) / rows + ker.mr - 1) / ker.mr * ker.mr;
+        const size_t tn = ((n + cols - 1) / cols + ker.nr - 1) / ker.nr * ker.nr;
+        rows = (m + tm - 1) / tm;
+        cols = (n + tn - 1) / tn;
+        TThreadPool::parallel_for(rows * cols, [&](size_t t) {
+            const size_t i0 = t / cols * tm, j0 = t % cols * tn;
+            gemm_serial(ker, std::min(tm, m - i0), std::min(tn, n - j0), k, alpha,
+                A + i0 * lda, lda, B + j0, ldb, beta, C + i0 * ldc + j0, ldc);
+        });
+    }
+
+private:
+    static void gemm_serial(const TGemmKernel<T>& ker, size_t m, size_t n, size_t k, T alpha,
+                            const T* A, size_t lda, const T* B, size_t ldb, T beta, T* C, size_t ldc)
+    {
+        const size_t mr = ker.mr, nr = ker.nr;
+
+        //  L1   B,  L2   A,  L3   B
+        const size_t kc_max = std::max<size_t>(16, L1_BYTES / 2 / (nr * sizeof(T)));
+        const size_t mc_max = std::max(mr, L2_BYTES / 2 / (kc_max * sizeof(T)) / mr * mr);
+        const size_t nc_max = std::max(nr, L3_BYTES / 2 / (kc_max * sizeof(T)) / nr * nr);
+
+        static thread_local TAlignedBuffer<T> bufA, bufB;
+        T* packA = bufA.reserve(mc_max * kc_max);
+        T* packB = bufB.reserve(kc_max * nc_max);
+
+        for (size_t jc = 0; jc < n; jc += nc_max) {
+            const size_t nc = std::min(nc_max, n - jc);
+            for (size_t pc = 0; pc < k; pc += kc_max) {
+                const size_t kc = std::min(kc_max, k - pc);
+                const T b = pc == 0 ? beta : T(1);
+                pack_b(kc, nc, nr, B + pc * ldb + jc, ldb, packB);
+                for (size_t ic = 0; ic < m; ic += mc_max) {
+                    const size_t mc = std::min(mc_max, m - ic);
+                    pack_a(mc, kc, mr, A + ic * lda + pc, lda, packA);
+                    macro_kernel(ker, mc, nc, kc, alpha, packA, packB, b, C + ic * ldc + jc, ldc);
+                }
+            }
+        }
+    }
+
+    //  A     mr ,  -  
+    static void pack_a(size_t mc, size_t kc, size_t mr, const T* A, size_t lda, T* dst)
+    {
+        for (size_t i = 0; i < mc; i += mr) {
+            const size_t rows = std::min(mr, mc - i);
+            for (size_t p = 0; p < kc; ++p) {
+                for (size_t r = 0; r < rows; ++r)
+                    dst[r] = A[(i + r) * lda + p];
+                for (size_t r = rows; r < mr; ++r)
+                    dst[r] = T();
+                dst += mr;
+            }
+        }
+    }
+
+    //  B     nr ,  -  
+    static void pack_b(size_t kc, size_t nc, size_t nr, const T* B, size_t ldb, T* dst)
+    {
+        for (size_t j = 0; j < nc; j += nr) {
+            const size_t cols = std::min(nr, nc - j);
+            for (size_t p = 0; p < kc; ++p) {
+                const T* b = B + p * ldb + j;
+                for (size_t c = 0; c < cols; ++c)
+                    dst[c] = b[c];
+                for (size_t c = cols; c < nr; ++c)
+                    dst[c] = T();
+                dst += nr;
+            }
+        }
+    }
+
+    static void macro_kernel(const TGemmKernel<T>& ker, size_t mc, size_t nc, size_t kc,
+                             T alpha, const T* packA, const T* packB, T beta, T* C, size_t ldc)
+    {
+        const size_t mr = ker.mr, nr = ker.nr;
+        T edge[MAX_TILE];
+        assert(mr * nr <= MAX_TILE && "GEMM micro-kernel tile is too large");
+        for (size_t jr = 0; jr < nc; jr += nr) {
+            const size_t cols = std::min(nr, nc - jr);
+            const T* b = packB + jr * kc;
+            for (size_t ir = 0; ir < mc; ir += mr) {
+                const size_t rows = std::min(mr, mc - ir);
+                const T* a = packA + ir * kc;
+                T* c = C + ir * ldc + jr;
+                if (rows == mr && cols == nr) {
+                    ker.ukernel(kc, a, b, c, ldc, alpha, beta);
+                    continue;
+                }
+                //        
+                ker.ukernel(kc, a, b, edge, nr, alpha, T());
+                for (size_t i = 0; i < rows; ++i)
+                    for (size_t j = 0; j < cols; ++j)
+                        c[i * ldc + j] = beta == T() ? edge[i * nr + j] : edge[i * nr + j] + beta * c[i * ldc + j];
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,467 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//    : CG, BiCGSTAB, GMRES(m)
+
+#ifndef __TKrylov_H__
+#define __TKrylov_H__
+
+#include <algorithm>
+#include <cmath>
+
+#include "tsparse.h"
+
+using namespace std;
+
+//  -
+//       y = A x. 
+// TDynamicMatrix (gemv),    multiply(x, y) (CSR, SELL, BSR)
+//    op(x, y)
+template<typename T>
+void apply_operator(const TDynamicMatrix<T>& a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+{
+    gemv(T(1), a, x, T(), y);
+}
+
+template<typename A, typename T>
+auto apply_operator(const A& a, const TDynamicVector<T>& x, TDynamicVector<T>& y) -> decltype(a.multiply(x, y), void())
+{
+    a.multiply(x, y);
+}
+
+template<typename A, typename T>
+auto apply_operator(const A& a, const TDynamicVector<T>& x, TDynamicVector<T>& y) -> decltype(a(x, y), void())
+{
+    a(x, y);
+}
+
+//   : z = r.   
+// apply(r, z) (TIlu0, TIlut, TIc0, TJacobi)   
+struct TIdentityPreconditioner
+{
+    template<typename T>
+    void apply(const TDynamicVector<T>& r, TDynamicVector<T>& z) const
+    {
+        if (&r != &z)
+            z = r;
+    }
+};
+
+//  :      ||r|| / ||b||
+template<typename T>
+struct TSolverResult
+{
+    size_t iterations = 0;
+    T residual = T();
+    bool converged = false;
+};
+
+//    -
+//      ,   -  EXPR_CHUNK:
+//         
+//  ,    L1,       
+// .      -    
+template<typename T>
+struct TKrylovKernels
+{
+    static constexpr size_t MAX_PARTS = 64;
+
+    // body(begin, end)  ;   
+    template<typename F>
+    static T reduce(size_t n, F body)
+    {
+        const size_t parts = std::max<size_t>(1, std::min({ TThreadPool::threads(), n / EXPR_GRAIN, MAX_PARTS }));
+        const size_t step = (n + parts - 1) / parts;
+        T partial[MAX_PARTS];
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            const size_t last = std::min(n, (t + 1) * step);
+            T s = T();
+            for (size_t i = t * step; i < last; i += EXPR_CHUNK)
+                s += body(i, std::min(last, i + EXPR_CHUNK));
+            partial[t] = s;
+        });
+        T s = T();
+        for (size_t t = 0; t < parts; ++t)
+            s += partial[t];
+        return s;
+    }
+
+    static void check(const TDynamicVector<T>& x, const TDynamicVector<T>& y)
+    {
+        if (x.size() != y.size())
+            throw invalid_argument("Vector sizes must be equal in Krylov solver");
+    }
+
+    static T dot(const TDynamicVector<T>& x, const TDynamicVector<T>& y)
+    {
+        const T* px = x.data();
+        const T* py = y.data();
+        return reduce(x.size(), [&](size_t b, size_t e) { return TVectorKernels<T>::dot(px + b, py + b, e - b); });
+    }
+
+    static T norm(const TDynamicVector<T>& x)
+    {
+        return std::sqrt(dot(x, x));
+    }
+
+    // y += a x
+    static void axpy(T a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+    {
+        const T* px = x.data();
+        T* py = y.data();
+        TThreadPool::parallel_blocks(x.size(), EXPR_GRAIN, [&](size_t b, size_t e) {
+            TVectorKernels<T>::axpy(a, px + b, py + b, e - b);
+        });
+    }
+
+    // y += a x,  (y, y)
+    static T axpy_norm2(T a, const TDynamicVector<T>& x, TDynamicVector<T>& y)
+    {
+        const T* px = x.data();
+        T* py = y.data();
+        return reduce(x.size(), [&](size_t b, size_t e) {
+            TVectorKernels<T>::axpy(a, px + b, py + b, e - b);
+            return TVectorKernels<T>::dot(py + b, py + b, e - b);
+        });
+    }
+
+    // y += a x,  (y, z)
+    static T axpy_dot(T a, const TDynamicVector<T>& x, TDynamicVector<T>& y, const TDynamicVector<T>& z)
+    {
+        const T* px = x.data();
+        const T* pz = z.data();
+        T* py = y.data();
+        return reduce(x.size(), [&](size_t b, size_t e) {
+            TVectorKernels<T>::axpy(a, px + b, py + b, e - b);
+            return TVectorKernels<T>::dot(py + b, pz + b, e - b);
+        });
+    }
+
+    // y = x + a y
+    static void xpay(const TDynamicVector<T>& x, T a, TDynamicVector<T>& y)
+    {
+        const T* px = x.data();
+        T* py = y.data();
+        TThreadPool::parallel_blocks(x.size(), EXPR_GRAIN, [&](size_t b, size_t e) {
+            TVectorKernels<T>::mul_scalar(py + b, a, py + b, e - b);
+            TVectorKernels<T>::add(px + b, py + b, py + b, e - b);
+        });
+    }
+
+    // r = b - y,  (r, r)
+    static T residual(const TDynamicVector<T>& b, const TDynamicVector<T>& y, TDynamicVector<T>& r)
+    {
+        const T* pb = b.data();
+        const T* py = y.data();
+        T* pr = r.data();
+        return reduce(b.size(), [&](size_t s, size_t e) {
+            TVectorKernels<T>::sub(pb + s, py + s, pr + s, e - s);
+            return TVectorKernels<T>::dot(pr + s, pr + s, e - s);
+        });
+    }
+};
+
+//   : ,    
+template<typename T>
+class TKrylovSolver
+{
+protected:
+    using K = TKrylovKernels<T>;
+
+    size_t n;
+    T tol;
+    size_t maxIter;
+
+    TKrylovSolver(size_t size, T tolerance, size_t max_iterations) : n(size), tol(tolerance), maxIter(max_iterations)
+    {
+        if (size == 0)
+            throw out_of_range("Krylov solver size should be greater than zero");
+        if (!(tolerance > T()))
+            throw invalid_argument("Krylov solver tolerance must be positive");
+    }
+
+    void check(const TDynamicVector<T>& b, const TDynamicVector<T>& x) const
+    {
+        if (b.size() != n || x.size() != n)
+            throw invalid_argument("Vector sizes must match the Krylov solver size");
+    }
+
+    //  b = 0  -  
+    static bool trivial(T bnorm, TDynamicVector<T>& x, TSolverResult<T>& res)
+    {
+        if (bnorm != T())
+            return false;
+        x *= T();
+        res.converged = true;
+        return true;
+    }
+
+public:
+    size_t size() const noexcept { return n; }
+    T tolerance() const noexcept { return tol; }
+    size_t max_iterations() const noexcept { return maxIter; }
+
+    void set_tolerance(T tolerance)
+    {
+        if (!(tolerance > T()))
+            throw invalid_argument("Krylov solver tolerance must be positive");
+        tol = tolerance;
+    }
+
+    void set_max_iterations(size_t max_iterations) noexcept { maxIter = max_iterations; }
+};
+
+//    -
+//     A  M.  
+//   ;     (r, r)
+template<typename T>
+class TConjugateGradient : public TKrylovSolver<T>
+{
+    using typename TKrylovSolver<T>::K;
+    using TKrylovSolver<T>::n;
+    using TKrylovSolver<T>::tol;
+    using TKrylovSolver<T>::maxIter;
+
+    TDynamicVector<T> r, z, p, q;
+
+public:
+    explicit TConjugateGradient(size_t size, T tolerance = T(1e-8), size_t max_iterations = 1000)
+        : TKrylovSolver<T>(size, tolerance, max_iterations), r(size), z(size), p(size), q(size)
+    {
+    }
+
+    // x -    
+    template<typename Op, typename Prec = TIdentityPreconditioner>
+    TSolverResult<T> solve(const Op& a, const TDynamicVector<T>& b, TDynamicVector<T>& x, const Prec& m = Prec())
+    {
+        this->check(b, x);
+        TSolverResult<T> res;
+        const T bnorm = K::norm(b);
+        if (this->trivial(bnorm, x, res))
+            return res;
+
+        apply_operator(a, x, q);
+        T rr = K::residual(b, q, r);
+        res.residual = std::sqrt(rr) / bnorm;
+        if (res.residual < tol) {
+            res.converged = true;
+            return res;
+        }
+        m.apply(r, z);
+        p = z;
+        T rz = K::dot(r, z);
+
+        while (res.iterations < maxIter) {
+            apply_operator(a, p, q);
+            const T alpha = rz / K::dot(p, q);
+            K::axpy(alpha, p, x);
+            rr = K::axpy_norm2(-alpha, q, r);
+            ++res.iterations;
+            res.residual = std::sqrt(rr) / bnorm;
+            if (res.residual < tol) {
+                res.converged = true;
+                break;
+            }
+            m.apply(r, z);
+            const T rzNew = K::dot(r, z);
+            K::xpay(z, rzNew / rz, p);
+            rz = rzNew;
+        }
+        return res;
+    }
+};
+
+// BiCGSTAB    -
+//   A;  s = r - alpha v    
+//  
+template<typename T>
+class TBiCgStab : public TKrylovSolver<T>
+{
+    using typename TKrylovSolver<T>::K;
+    using TKrylovSolver<T>::n;
+    using TKrylovSolver<T>::tol;
+    using TKrylovSolver<T>::maxIter;
+
+    TDynamicVector<T> r, r0, p, v, s, t, ph, sh;
+
+public:
+    explicit TBiCgStab(size_t size, T tolerance = T(1e-8), size_t max_iterations = 1000)
+        : TKrylovSolver<T>(size, tolerance, max_iterations),
+          r(size), r0(size), p(size), v(size), s(size), t(size), ph(size), sh(size)
+    {
+    }
+
+    template<typename Op, typename Prec = TIdentityPreconditioner>
+    TSolverResult<T> solve(const Op& a, const TDynamicVector<T>& b, TDynamicVector<T>& x, const Prec& m = Prec())
+    {
+        this->check(b, x);
+        TSolverResult<T> res;
+        const T bnorm = K::norm(b);
+        if (this->trivial(bnorm, x, res))
+            return res;
+
+        apply_operator(a, x, v);
+        res.residual = std::sqrt(K::residual(b, v, r)) / bnorm;
+        if (res.residual < tol) {
+            res.converged = true;
+            return res;
+        }
+        r0 = r;
+        p *= T();
+        v *= T();
+        T rho = T(1), alpha = T(1), omega = T(1);
+
+        while (res.iterations < maxIter) {
+            const T rhoNew = K::dot(r0, r);
+            if (rhoNew == T())
+                break;
+            // p = r + beta (p - omega v)
+            K::axpy(-omega, v, p);
+            K::xpay(r, (rhoNew / rho) * (alpha / omega), p);
+            rho = rhoNew;
+
+            m.apply(p, ph);
+            apply_operator(a, ph, v);
+            alpha = rho / K::dot(r0, v);
+            s = r;
+            const T ss = K::axpy_norm2(-alpha, v, s);
+            ++res.iterations;
+            if (std::sqrt(ss) / bnorm < tol) {
+                K::axpy(alpha, ph, x);
+                res.residual = std::sqrt(ss) / bnorm;
+                res.converged = true;
+                break;
+            }
+
+            m.apply(s, sh);
+            apply_operator(a, sh, t);
+            const T tt = K::dot(t, t);
+            omega = tt == T() ? T() : K::dot(t, s) / tt;
+            K::axpy(alpha, ph, x);
+            K::axpy(omega, sh, x);
+            r = s;
+            res.residual = std::sqrt(K::axpy_norm2(-omega, t, r)) / bnorm;
+            if (res.residual < tol) {
+                res.converged = true;
+                break;
+            }
+            if (omega == T())
+                break;
+        }
+        return res;
+    }
+};
+
+// GMRES(m)    -
+//    m + 1  (  - ),
+//       ,
+//          x.
+//      
+template<typename T>
+class TGmres : public TKrylovSolver<T>
+{
+    using typename TKrylovSolver<T>::K;
+    using TKrylovSolver<T>::n;
+    using TKrylovSolver<T>::tol;
+    using TKrylovSolver<T>::maxIter;
+
+    size_t m;
+    vector<TDynamicVector<T>> basis;
+    TDynamicVector<T> w, z;
+    vector<T> h, cs, sn, g;
+
+    T& hess(size_t i, size_t j) noexcept { return h[i * m + j]; }
+
+public:
+    TGmres(size_t size, size_t restart = 30, T tolerance = T(1e-8), size_t max_iterations = 1000)
+        : TKrylovSolver<T>(size, tolerance, max_iterations), m(restart), w(size), z(size)
+    {
+        if (restart == 0)
+            throw out_of_range("GMRES restart length should be greater than zero");
+        basis.reserve(m + 1);
+        for (size_t i = 0; i <= m; ++i)
+            basis.emplace_back(size);
+        h.assign((m + 1) * m, T());
+        cs.assign(m, T());
+        sn.assign(m, T());
+        g.assign(m + 1, T());
+    }
+
+    size_t restart() const noexcept { return m; }
+
+    template<typename Op, typename Prec = TIdentityPreconditioner>
+    TSolverResult<T> solve(const Op& a, const TDynamicVector<T>& b, TDynamicVector<T>& x, const Prec& prec = Prec())
+    {
+        this->check(b, x);
+        TSolverResult<T> res;
+        const T bnorm = K::norm(b);
+        if (this->trivial(bnorm, x, res))
+            return res;
+
+        for (;;) {
+            apply_operator(a, x, w);
+            const T beta = std::sqrt(K::residual(b, w, basis[0]));
+            res.residual = beta / bnorm;
+            if (res.residual < tol) {
+                res.converged = true;
+                break;
+            }
+            if (res.iterations >= maxIter)
+                break;
+            basis[0] *= T(1) / beta;
+            std::fill(g.begin(), g.end(), T());
+            g[0] = beta;
+
+            size_t k = 0;
+            while (k < m && res.iterations < maxIter) {
+                prec.apply(basis[k], z);
+                apply_operator(a, z, w);
+                for (size_t i = 0; i <= k; ++i) {
+                    hess(i, k) = K::dot(w, basis[i]);
+                    K::axpy(-hess(i, k), basis[i], w);
+                }
+                const T hk = K::norm(w);
+                hess(k + 1, k) = hk;
+                if (hk != T()) {
+                    basis[k + 1] = w;
+                    basis[k + 1] *= T(1) / hk;
+                }
+
+                //     ,   
+                for (size_t i = 0; i < k; ++i) {
+                    const T t = cs[i] * hess(i, k) + sn[i] * hess(i + 1, k);
+                    hess(i + 1, k) = -sn[i] * hess(i, k) + cs[i] * hess(i + 1, k);
+                    hess(i, k) = t;
+                }
+                const T d = std::hypot(hess(k, k), hess(k + 1, k));
+                cs[k] = d == T() ? T(1) : hess(k, k) / d;
+                sn[k] = d == T() ? T() : hess(k + 1, k) / d;
+                hess(k, k) = d;
+                hess(k + 1, k) = T();
+                g[k + 1] = -sn[k] * g[k];
+                g[k] = cs[k] * g[k];
+
+                ++k;
+                ++res.iterations;
+                if (std::abs(g[k]) / bnorm < tol || hk == T())
+                    break;
+            }
+
+            // y = H^-1 g   (  g), x += M^-1 (V y)
+            for (size_t i = k; i-- > 0;) {
+                for (size_t j = i + 1; j < k; ++j)
+                    g[i] -= hess(i, j) * g[j];
+                g[i] /= hess(i, i);
+            }
+            w *= T();
+            for (size_t i = 0; i < k; ++i)
+                K::axpy(g[i], basis[i], w);
+            prec.apply(w, z);
+            K::axpy(T(1), z, x);
+        }
+        return res;
+    }
+};
+
+#endif
@@ -12,6 +12,12 @@
 #include <algorithm>
 #include <cassert>
 #include <iomanip>
+#include <memory>
+#include <new>
+
+#include "tsimd.h"
+#include "tgemm.h"
+#include "texpr.h"
 
 using namespace std;
 
@@ -21,12 +27,25 @@ const int MAX_MATRIX_SIZE = 10000;
 //   - 
 //     
 template<typename T>
-class TDynamicVector
+class TDynamicVector : public TExpr<TDynamicVector<T>>
 {
 protected:
     size_t sz;
     T* pMem;
+
+    //  :   ,    
+    struct no_init_t {};
+    static constexpr no_init_t no_init = {};
+
+    TDynamicVector(size_t size, no_init_t) : sz(size)
+    {
+        pMem = new T[sz];
+    }
 public:
+    using container = TDynamicVector;
+    using value_type = T;
+    static constexpr bool is_leaf = true;
+
     TDynamicVector(size_t size = 1) : sz(size)
     {
         if (sz == 0)
@@ -43,8 +62,17 @@ public:
         if (sz > MAX_VECTOR_SIZE)
             throw out_of_range("Vector size exceeds maximum allowed");
         assert(arr != nullptr && "TDynamicVector ctor requires non-nullptr arg");
+        pMem = new T[sz];
+        std::copy(arr, arr + sz, pMem);
+    }
+
+
+    //        
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TDynamicVector(const TExpr<E>& e) : TDynamicVector(e.self().size(), no_init)
+    {
+        expr_assign(e.self(), pMem, false);
     }
-       
 
     TDynamicVector(const TDynamicVector& v) : sz(v.sz)
     {
@@ -96,7 +124,28 @@ public:
         return *this;
     }
 
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TDynamicVector& operator=(const TExpr<E>& e)
+    {
+        const E& x = e.self();
+        if (sz != x.size()) {
+            TDynamicVector tmp(x);
+            swap(*this, tmp);
+            return *this;
+        }
+        expr_assign(x, pMem, x.expr_references(pMem));
+        return *this;
+    }
+
     size_t size() const noexcept { return sz; }
+    T* data() noexcept { return pMem; }
+    const T* data() const noexcept { return pMem; }
+
+    //     
+    size_t expr_length() const noexcept { return sz; }
+    const T* expr_direct(size_t first) const noexcept { return pMem + first; }
+    void expr_eval(size_t first, size_t n, T* out) const { std::copy(pMem + first, pMem + first + n, out); }
+    bool expr_references(const void* p) const noexcept { return p == pMem; }
 
     // 
     T& operator[](size_t ind)
@@ -139,69 +188,147 @@ public:
         return !(*this == v);
     }
 
-    //  
-    TDynamicVector operator+(T val)
+    //  :    ,   
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TDynamicVector& operator+=(const TExpr<E>& v)
     {
-        TDynamicVector result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result.pMem[i] = pMem[i] + val;
-        }
-        return result;
+        if (sz != v.self().size())
+            throw invalid_argument("Vector sizes must be equal for addition");
+
+        expr_compound<TExprAdd>(v.self(), pMem);
+        return *this;
     }
 
-    TDynamicVector operator-(T val)
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TDynamicVector& operator-=(const TExpr<E>& v)
     {
-        TDynamicVector result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result.pMem[i] = pMem[i] - val;
-        }
-        return result;
+        if (sz != v.self().size())
+            throw invalid_argument("Vector sizes must be equal for subtraction");
+
+        expr_compound<TExprSub>(v.self(), pMem);
+        return *this;
     }
 
-    TDynamicVector operator*(T val)
+    TDynamicVector& operator+=(T val)
     {
-        TDynamicVector result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result.pMem[i] = pMem[i] * val;
-        }
-        return result;
+        TVectorKernels<T>::add_scalar(pMem, val, pMem, sz);
+        return *this;
+    }
+
+    TDynamicVector& operator-=(T val)
+    {
+        TVectorKernels<T>::sub_scalar(pMem, val, pMem, sz);
+        return *this;
+    }
+
+    TDynamicVector& operator*=(T val)
+    {
+        TVectorKernels<T>::mul_scalar(pMem, val, pMem, sz);
+        return *this;
+    }
+
+    //   (,   );
+    //         
+    TExprScalar<TDynamicVector, TExprAdd> operator+(T val) const&
+    {
+        return TExprScalar<TDynamicVector, TExprAdd>(*this, val);
+    }
+
+    TDynamicVector operator+(T val) &&
+    {
+        *this += val;
+        return std::move(*this);
+    }
+
+    TExprScalar<TDynamicVector, TExprSub> operator-(T val) const&
+    {
+        return TExprScalar<TDynamicVector, TExprSub>(*this, val);
+    }
+
+    TDynamicVector operator-(T val) &&
+    {
+        *this -= val;
+        return std::move(*this);
+    }
+
+    TExprScalar<TDynamicVector, TExprMul> operator*(T val) const&
+    {
+        return TExprScalar<TDynamicVector, TExprMul>(*this, val);
+    }
+
+    TDynamicVector operator*(T val) &&
+    {
+        *this *= val;
+        return std::move(*this);
     }
 
     //  
-    TDynamicVector operator+(const TDynamicVector& v)
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TExprBinary<TDynamicVector, E, TExprAdd> operator+(const TExpr<E>& v) const&
+    {
+        if (sz != v.self().size())
+            throw invalid_argument("Vector sizes must be equal for addition");
+
+        return TExprBinary<TDynamicVector, E, TExprAdd>(*this, v.self());
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TDynamicVector operator+(const TExpr<E>& v) &&
+    {
+        *this += v;
+        return std::move(*this);
+    }
+
+    TDynamicVector operator+(TDynamicVector&& v) const&
     {
         if (sz != v.sz)
             throw invalid_argument("Vector sizes must be equal for addition");
 
-        TDynamicVector result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result.pMem[i] = pMem[i] + v.pMem[i];
-        }
-        return result;
+        v += *this;
+        return std::move(v);
+    }
+
+    TDynamicVector operator+(TDynamicVector&& v) &&
+    {
+        return std::move(*this) + static_cast<const TDynamicVector&>(v);
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TExprBinary<TDynamicVector, E, TExprSub> operator-(const TExpr<E>& v) const&
+    {
+        if (sz != v.self().size())
+            throw invalid_argument("Vector sizes must be equal for subtraction");
+
+        return TExprBinary<TDynamicVector, E, TExprSub>(*this, v.self());
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicVector>>
+    TDynamicVector operator-(const TExpr<E>& v) &&
+    {
+        *this -= v;
+        return std::move(*this);
     }
 
-    TDynamicVector operator-(const TDynamicVector& v)
+    TDynamicVector operator-(TDynamicVector&& v) const&
     {
         if (sz != v.sz)
             throw invalid_argument("Vector sizes must be equal for subtraction");
 
-        TDynamicVector result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result.pMem[i] = pMem[i] - v.pMem[i];
-        }
-        return result;
+        v = TExprBinary<TDynamicVector, TDynamicVector, TExprSub>(*this, v);
+        return std::move(v);
     }
 
-    T operator*(const TDynamicVector& v)
+    TDynamicVector operator-(TDynamicVector&& v) &&
+    {
+        return std::move(*this) - static_cast<const TDynamicVector&>(v);
+    }
+
+    T operator*(const TDynamicVector& v) const
     {
         if (sz != v.sz)
             throw invalid_argument("Vector sizes must be equal for dot product");
 
-        T result = T();
-        for (size_t i = 0; i < sz; ++i) {
-            result += pMem[i] * v.pMem[i];
-        }
-        return result;
+        return TVectorKernels<T>::dot(pMem, v.pMem, sz);
     }
 
     friend void swap(TDynamicVector& lhs, TDynamicVector& rhs) noexcept
@@ -231,118 +358,475 @@ public:
 };
 
 
+
+
+//   - 
+//        
+template<typename U>
+class TMatrixRow
+{
+    U* pRow;
+    size_t sz;
+public:
+    using value_type = typename remove_const<U>::type;
+
+    TMatrixRow(U* row, size_t size) noexcept : pRow(row), sz(size) {}
+    TMatrixRow(const TMatrixRow&) = default;
+
+    //   ,    
+    TMatrixRow& operator=(const TMatrixRow& r)
+    {
+        if (sz != r.sz)
+            throw invalid_argument("Row sizes must be equal for assignment");
+        std::copy(r.pRow, r.pRow + sz, pRow);
+        return *this;
+    }
+
+    TMatrixRow& operator=(const TDynamicVector<value_type>& v)
+    {
+        if (sz != v.size())
+            throw invalid_argument("Row and vector sizes must be equal for assignment");
+        for (size_t i = 0; i < sz; ++i)
+            pRow[i] = v[i];
+        return *this;
+    }
+
+    size_t size() const noexcept { return sz; }
+    U* data() const noexcept { return pRow; }
+
+    // 
+    U& operator[](size_t ind) const
+    {
+        return pRow[ind];
+    }
+
+    //   
+    U& at(size_t ind) const
+    {
+        if (ind >= sz)
+            throw out_of_range("Index out of range in at()");
+        return pRow[ind];
+    }
+
+    operator TDynamicVector<value_type>() const
+    {
+        TDynamicVector<value_type> v(sz);
+        std::copy(pRow, pRow + sz, &v[0]);
+        return v;
+    }
+};
+
+
 //   - 
 //     
+//         ,  
+//    - (   - stride)
 template<typename T>
-class TDynamicMatrix : private TDynamicVector<TDynamicVector<T>>
+class TDynamicMatrix : public TExpr<TDynamicMatrix<T>>
 {
-    using TDynamicVector<TDynamicVector<T>>::pMem;
-    using TDynamicVector<TDynamicVector<T>>::sz;
+    static constexpr size_t ALIGNMENT = 64;
 
-public:
-    TDynamicMatrix(size_t s = 1) : TDynamicVector<TDynamicVector<T>>(s)
+    size_t sz;
+    size_t stride;
+    T* pMem;
+
+    static size_t row_stride(size_t s) noexcept
     {
+        const size_t line = ALIGNMENT % sizeof(T) == 0 ? ALIGNMENT / sizeof(T) : 1;
+        return (s + line - 1) / line * line;
+    }
+
+    static T* allocate(size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), align_val_t(ALIGNMENT)));
+    }
+
+    static void deallocate(T* p) noexcept
+    {
+        ::operator delete(p, align_val_t(ALIGNMENT));
+    }
+
+    static void check_size(size_t s)
+    {
+        if (s == 0)
+            throw out_of_range("Matrix size should be greater than zero");
         if (s > MAX_MATRIX_SIZE)
             throw out_of_range("Matrix size exceeds maximum allowed");
+    }
+
+    size_t capacity() const noexcept { return sz * stride; }
+
+    //     operator*=  
+    static constexpr size_t SCRATCH_LIMIT = size_t(1) << 18;
+
+    static TDynamicMatrix& scratch()
+    {
+        static thread_local TDynamicMatrix s;
+        return s;
+    }
+
+    T* row(size_t i) noexcept { return pMem + i * stride; }
+    const T* row(size_t i) const noexcept { return pMem + i * stride; }
 
-        for (size_t i = 0; i < sz; i++)
-            pMem[i] = TDynamicVector<T>(sz);
+    //  :   ,    
+    struct no_init_t {};
+    static constexpr no_init_t no_init = {};
+
+    TDynamicMatrix(size_t s, no_init_t) : sz(s), stride(row_stride(s))
+    {
+        pMem = allocate(capacity());
+        try {
+            std::uninitialized_default_construct_n(pMem, capacity());
+        }
+        catch (...) {
+            deallocate(pMem);
+            throw;
+        }
+    }
+
+public:
+    using container = TDynamicMatrix;
+    using value_type = T;
+    static constexpr bool is_leaf = true;
+
+    TDynamicMatrix(size_t s = 1) : sz(s), stride(row_stride(s))
+    {
+        check_size(s);
+        pMem = allocate(capacity());
+        try {
+            std::uninitialized_value_construct_n(pMem, capacity());
+        }
+        catch (...) {
+            deallocate(pMem);
+            throw;
+        }
+    }
+
+    //        
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TDynamicMatrix(const TExpr<E>& e) : TDynamicMatrix(e.self().size(), no_init)
+    {
+        expr_assign(e.self(), pMem, false);
+    }
+
+    TDynamicMatrix(const TDynamicMatrix& m) : sz(m.sz), stride(m.stride)
+    {
+        pMem = allocate(capacity());
+        try {
+            std::uninitialized_copy_n(m.pMem, capacity(), pMem);
+        }
+        catch (...) {
+            deallocate(pMem);
+            throw;
+        }
+    }
+
+    TDynamicMatrix(TDynamicMatrix&& m) noexcept : sz(m.sz), stride(m.stride), pMem(m.pMem)
+    {
+        m.sz = 0;
+        m.stride = 0;
+        m.pMem = nullptr;
+    }
+
+    ~TDynamicMatrix()
+    {
+        if (pMem != nullptr) {
+            std::destroy_n(pMem, capacity());
+            deallocate(pMem);
+            pMem = nullptr;
+        }
+        sz = 0;
+    }
+
+    TDynamicMatrix& operator=(const TDynamicMatrix& m)
+    {
+        if (this == &m) return *this;
+
+        if (sz != m.sz) {
+            TDynamicMatrix tmp(m);
+            swap(*this, tmp);
+            return *this;
+        }
+
+        std::copy(m.pMem, m.pMem + capacity(), pMem);
+        return *this;
+    }
+
+    TDynamicMatrix& operator=(TDynamicMatrix&& m) noexcept
+    {
+        if (this == &m) return *this;
+
+        TDynamicMatrix tmp(std::move(m));
+        swap(*this, tmp);
+        return *this;
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TDynamicMatrix& operator=(const TExpr<E>& e)
+    {
+        const E& x = e.self();
+        if (sz != x.size()) {
+            TDynamicMatrix tmp(x);
+            swap(*this, tmp);
+            return *this;
+        }
+        expr_assign(x, pMem, x.expr_references(pMem));
+        return *this;
     }
 
     size_t size() const noexcept { return sz; }
 
-    using TDynamicVector<TDynamicVector<T>>::operator[];
-    using TDynamicVector<TDynamicVector<T>>::at;
+    //   ,  i   data() + i * ld()
+    T* data() noexcept { return pMem; }
+    const T* data() const noexcept { return pMem; }
+    size_t ld() const noexcept { return stride; }
+
+    //     :    
+    //      sz * stride
+    size_t expr_length() const noexcept { return capacity(); }
+    const T* expr_direct(size_t first) const noexcept { return pMem + first; }
+    void expr_eval(size_t first, size_t n, T* out) const { std::copy(pMem + first, pMem + first + n, out); }
+    bool expr_references(const void* p) const noexcept { return p == pMem; }
+
+    // 
+    TMatrixRow<T> operator[](size_t ind)
+    {
+        return TMatrixRow<T>(row(ind), sz);
+    }
+
+    TMatrixRow<const T> operator[](size_t ind) const
+    {
+        return TMatrixRow<const T>(row(ind), sz);
+    }
+
+    //   
+    TMatrixRow<T> at(size_t ind)
+    {
+        if (ind >= sz)
+            throw out_of_range("Row index out of range in at()");
+        return TMatrixRow<T>(row(ind), sz);
+    }
+
+    TMatrixRow<const T> at(size_t ind) const
+    {
+        if (ind >= sz)
+            throw out_of_range("Row index out of range in at() const");
+        return TMatrixRow<const T>(row(ind), sz);
+    }
 
     // 
     bool operator==(const TDynamicMatrix& m) const  
     {
         if (sz != m.sz) return false;
         for (size_t i = 0; i < sz; ++i) {
-            if (pMem[i] != m.pMem[i]) return false;
+            if (!std::equal(row(i), row(i) + sz, m.row(i))) return false;
         }
         return true;
     }
  
-    // - 
-    TDynamicMatrix operator*(const T& val)
+    //  :    ,   
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TDynamicMatrix& operator+=(const TExpr<E>& m)
     {
-        TDynamicMatrix result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result[i] = pMem[i] * val;
+        if (sz != m.self().size())
+            throw invalid_argument("Matrix sizes must be equal for addition");
+
+        expr_compound<TExprAdd>(m.self(), pMem);
+        return *this;
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TDynamicMatrix& operator-=(const TExpr<E>& m)
+    {
+        if (sz != m.self().size())
+            throw invalid_argument("Matrix sizes must be equal for subtraction");
+
+        expr_compound<TExprSub>(m.self(), pMem);
+        return *this;
+    }
+
+    TDynamicMatrix& operator*=(const T& val)
+    {
+        TVectorKernels<T>::mul_scalar(pMem, val, pMem, capacity());
+        return *this;
+    }
+
+    //      ,   
+    //  :      
+    // ,       .  
+    //      SCRATCH_LIMIT ; 
+    //   ,      n^3 
+    TDynamicMatrix& operator*=(const TDynamicMatrix& m)
+    {
+        if (sz != m.sz)
+            throw invalid_argument("Matrix sizes must be equal for multiplication");
+
+        if (capacity() > SCRATCH_LIMIT) {
+            TDynamicMatrix tmp(sz, no_init);
+            product(T(1), *this, m, T(), tmp);
+            swap(*this, tmp);
+            return *this;
         }
-        return result;
+        TDynamicMatrix& s = scratch();
+        if (s.sz != sz)
+            s = TDynamicMatrix(sz, no_init);
+        product(T(1), *this, m, T(), s);
+        swap(*this, s);
+        return *this;
+    }
+
+    //    operator*=   
+    static void release_scratch()
+    {
+        scratch() = TDynamicMatrix();
+    }
+
+    // - ;    
+    //     
+    TExprScalar<TDynamicMatrix, TExprMul> operator*(const T& val) const&
+    {
+        return TExprScalar<TDynamicMatrix, TExprMul>(*this, val);
+    }
+
+    TDynamicMatrix operator*(const T& val) &&
+    {
+        *this *= val;
+        return std::move(*this);
     }
 
     TDynamicMatrix operator+(const T& val) { return *this + TDynamicMatrix(sz) * val; }
     TDynamicMatrix operator-(const T& val) { return *this - TDynamicMatrix(sz) * val; }
 
     // - 
-    TDynamicVector<T> operator*(const TDynamicVector<T>& v)
+    TDynamicVector<T> operator*(const TDynamicVector<T>& v) const
     {
         if (sz != v.size())
             throw invalid_argument("Matrix columns must equal vector size for multiplication");
 
         TDynamicVector<T> result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            T sum = T();
-            for (size_t j = 0; j < sz; ++j) {
-                sum += pMem[i][j] * v[j];
-            }
-            result[i] = sum;
-        }
+        gemv(T(1), *this, v, T(), result);
         return result;
     }
 
     // - 
-    TDynamicMatrix operator+(const TDynamicMatrix& m)
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TExprBinary<TDynamicMatrix, E, TExprAdd> operator+(const TExpr<E>& m) const&
+    {
+        if (sz != m.self().size())
+            throw invalid_argument("Matrix sizes must be equal for addition");
+
+        return TExprBinary<TDynamicMatrix, E, TExprAdd>(*this, m.self());
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TDynamicMatrix operator+(const TExpr<E>& m) &&
+    {
+        *this += m;
+        return std::move(*this);
+    }
+
+    TDynamicMatrix operator+(TDynamicMatrix&& m) const&
     {
         if (sz != m.sz)
             throw invalid_argument("Matrix sizes must be equal for addition");
 
-        TDynamicMatrix result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result[i] = pMem[i] + m.pMem[i];
-        }
-        return result;
+        m += *this;
+        return std::move(m);
+    }
+
+    TDynamicMatrix operator+(TDynamicMatrix&& m) &&
+    {
+        return std::move(*this) + static_cast<const TDynamicMatrix&>(m);
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TExprBinary<TDynamicMatrix, E, TExprSub> operator-(const TExpr<E>& m) const&
+    {
+        if (sz != m.self().size())
+            throw invalid_argument("Matrix sizes must be equal for subtraction");
+
+        return TExprBinary<TDynamicMatrix, E, TExprSub>(*this, m.self());
+    }
+
+    template<typename E, typename = TExprSameKind<E, TDynamicMatrix>>
+    TDynamicMatrix operator-(const TExpr<E>& m) &&
+    {
+        *this -= m;
+        return std::move(*this);
     }
 
-    TDynamicMatrix operator-(const TDynamicMatrix& m)
+    TDynamicMatrix operator-(TDynamicMatrix&& m) const&
     {
         if (sz != m.sz)
             throw invalid_argument("Matrix sizes must be equal for subtraction");
 
-        TDynamicMatrix result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            result[i] = pMem[i] - m.pMem[i];
-        }
-        return result;
+        m = TExprBinary<TDynamicMatrix, TDynamicMatrix, TExprSub>(*this, m);
+        return std::move(m);
+    }
+
+    TDynamicMatrix operator-(TDynamicMatrix&& m) &&
+    {
+        return std::move(*this) - static_cast<const TDynamicMatrix&>(m);
     }
 
-    TDynamicMatrix operator*(const TDynamicMatrix& m)
+    TDynamicMatrix operator*(const TDynamicMatrix& m) const
     {
         if (sz != m.sz)
             throw invalid_argument("Matrix sizes must be equal for multiplication");
 
-        TDynamicMatrix result(sz);
-        for (size_t i = 0; i < sz; ++i) {
-            for (size_t j = 0; j < sz; ++j) {
-                T sum = T();
-                for (size_t k = 0; k < sz; ++k) {
-                    sum += pMem[i][k] * m.pMem[k][j];
-                }
-                result[i][j] = sum;
-            }
-        }
+        TDynamicMatrix result(sz, no_init);
+        product(T(1), *this, m, T(), result);
         return result;
     }
 
+    // c = alpha * a * b + beta * c   ; 
+    //       .
+    //  beta == 0   c  
+    friend void gemm(const T& alpha, const TDynamicMatrix& a, const TDynamicMatrix& b,
+                     const T& beta, TDynamicMatrix& c)
+    {
+        if (a.sz != b.sz || a.sz != c.sz)
+            throw invalid_argument("Matrix sizes must be equal for gemm");
+        if (&c == &a || &c == &b)
+            throw invalid_argument("Output matrix of gemm must not alias an operand");
+
+        product(alpha, a, b, beta, c);
+    }
+
+    // y = alpha * a * x + beta * y;   y   
+    friend void gemv(const T& alpha, const TDynamicMatrix& a, const TDynamicVector<T>& x,
+                     const T& beta, TDynamicVector<T>& y)
+    {
+        if (a.sz != x.size() || a.sz != y.size())
+            throw invalid_argument("Matrix and vector sizes must be equal for gemv");
+        if (&x == &y)
+            throw invalid_argument("Output vector of gemv must not alias an operand");
+
+        //        EXPR_GRAIN 
+        const T* px = x.data();
+        T* py = y.data();
+        const size_t grain = std::max<size_t>(1, EXPR_GRAIN / a.stride);
+        TThreadPool::parallel_blocks(a.sz, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const T dot = TVectorKernels<T>::dot(a.row(i), px, a.sz);
+                py[i] = beta == T() ? alpha * dot : alpha * dot + beta * py[i];
+            }
+        });
+    }
+
+    friend void swap(TDynamicMatrix& lhs, TDynamicMatrix& rhs) noexcept
+    {
+        std::swap(lhs.sz, rhs.sz);
+        std::swap(lhs.stride, rhs.stride);
+        std::swap(lhs.pMem, rhs.pMem);
+    }
+
     // /
     friend istream& operator>>(istream& istr, TDynamicMatrix& m)
     {
         for (size_t i = 0; i < m.sz; ++i) {
             for (size_t j = 0; j < m.sz; ++j) {
-                istr >> m.pMem[i][j];
+                istr >> m.row(i)[j];
             }
         }
         return istr;
@@ -354,14 +838,68 @@ public:
         for (size_t i = 0; i < m.sz; ++i) {
             ostr << "  [ ";
             for (size_t j = 0; j < m.sz; ++j) {
-                ostr << setw(6) << m.pMem[i][j];
+                ostr << setw(6) << m.row(i)[j];
             }
             ostr << " ]\n";
         }
         return ostr;
     }
 
-     
+private:
+    // out = alpha * a * b + beta * out;    
+    // (TGemm),  -   i-k-j,       
+    static void product(const T& alpha, const TDynamicMatrix& a, const TDynamicMatrix& b,
+                        const T& beta, TDynamicMatrix& out)
+    {
+        const size_t n = a.sz;
+        //     
+        for (size_t i = 0; i < n; ++i)
+            std::fill(out.row(i) + n, out.row(i) + out.stride, T());
+        if (n >= TGemm<T>::BLOCKED_THRESHOLD) {
+            TGemm<T>::gemm(n, n, n, alpha, a.pMem, a.stride, b.pMem, b.stride, beta, out.pMem, out.stride);
+            return;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const T* ai = a.row(i);
+            T* r = out.row(i);
+            if (beta == T())
+                std::fill(r, r + n, T());
+            else if (beta != T(1))
+                TVectorKernels<T>::mul_scalar(r, beta, r, n);
+            for (size_t k = 0; k < n; ++k) {
+                const T aik = alpha * ai[k];
+                const T* bk = b.row(k);
+                for (size_t j = 0; j < n; ++j) {
+                    r[j] += aik * bk[j];
+                }
+            }
+        }
+    }
 };
 
+
+//      -
+//     ,    
+template<typename L, typename C, typename = typename enable_if<!L::is_leaf && C::is_leaf &&
+    is_same<typename L::container, C>::value>::type>
+C operator+(const TExpr<L>& l, C&& r)
+{
+    r += l;
+    return std::move(r);
+}
+
+template<typename L, typename C, typename = typename enable_if<!L::is_leaf && C::is_leaf &&
+    is_same<typename L::container, C>::value>::type>
+C operator-(const TExpr<L>& l, C&& r)
+{
+    r = TExprBinary<L, C, TExprSub>(l.self(), r);
+    return std::move(r);
+}
+
+template<typename C, typename = typename enable_if<C::is_leaf>::type>
+C operator*(const typename C::value_type& val, C&& r)
+{
+    return std::move(r) * val;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,391 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//       Matrix Market (.mtx)
+
+#ifndef __TMtx_H__
+#define __TMtx_H__
+
+#include <atomic>
+#include <charconv>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "tsparsebuilder.h"
+
+using namespace std;
+
+//   Matrix Market -
+// "%%MatrixMarket matrix <format> <field> <symmetry>"   ;
+//    (array) entries =   
+struct TMtxHeader
+{
+    enum class Format { Coordinate, Array };
+    enum class Field { Real, Integer, Pattern };
+    enum class Symmetry { General, Symmetric, SkewSymmetric };
+
+    Format format = Format::Coordinate;
+    Field field = Field::Real;
+    Symmetry symmetry = Symmetry::General;
+    size_t rows = 0, cols = 0, entries = 0;
+};
+
+// Matrix Market -
+//      CHUNK ,    
+//      ,   std::from_chars.
+//        .     .
+//        
+// ; complex  hermitian  
+class TMatrixMarket
+{
+    static constexpr size_t CHUNK = size_t(1) << 22;
+
+    static string lower(string s)
+    {
+        for (char& c : s)
+            c = char(std::tolower(static_cast<unsigned char>(c)));
+        return s;
+    }
+
+    static bool blank(char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+
+    //   :   
+    static bool skip_line(const char* p, const char* end) noexcept
+    {
+        while (p < end && blank(*p))
+            ++p;
+        return p == end || *p == '%';
+    }
+
+    template<typename V>
+    static const char* parse(const char* p, const char* end, V& value)
+    {
+        while (p < end && blank(*p))
+            ++p;
+        const from_chars_result r = std::from_chars(p, end, value);
+        if (r.ec != errc() || (r.ptr < end && !blank(*r.ptr)))
+            throw invalid_argument("Malformed Matrix Market entry");
+        return r.ptr;
+    }
+
+    template<typename T>
+    static const char* parse_value(const char* p, const char* end, TMtxHeader::Field field, T& value)
+    {
+        if (field == TMtxHeader::Field::Pattern) {
+            value = T(1);
+            return p;
+        }
+        if (field == TMtxHeader::Field::Integer) {
+            long long v;
+            p = parse(p, end, v);
+            value = T(v);
+            return p;
+        }
+        double v;
+        p = parse(p, end, v);
+        value = T(v);
+        return p;
+    }
+
+    //     :  , 
+    //  -    (   )
+    struct TArrayPos
+    {
+        size_t i = 0, j = 0, rows, skip;
+        bool general;
+
+        TArrayPos(const TMtxHeader& h, size_t k)
+            : rows(h.rows), skip(h.symmetry == TMtxHeader::Symmetry::SkewSymmetric ? 1 : 0),
+              general(h.symmetry == TMtxHeader::Symmetry::General)
+        {
+            if (general) {
+                i = k % rows;
+                j = k / rows;
+                return;
+            }
+            while (j < rows && k >= rows - j - skip) {
+                k -= rows - j - skip;
+                ++j;
+            }
+            i = j + skip + k;
+        }
+
+        void next() noexcept
+        {
+            if (++i < rows)
+                return;
+            ++j;
+            i = general ? 0 : j + skip;
+        }
+    };
+
+    //   -
+    // sink(i, j, value)     (  ),  
+    //      
+    template<typename T, typename Sink>
+    static void read_body(istream& istr, const TMtxHeader& h, Sink sink)
+    {
+        const bool coordinate = h.format == TMtxHeader::Format::Coordinate;
+        const bool mirror = h.symmetry != TMtxHeader::Symmetry::General;
+        const bool skew = h.symmetry == TMtxHeader::Symmetry::SkewSymmetric;
+        auto emit = [&](size_t i, size_t j, const T& v) {
+            sink(i, j, v);
+            if (mirror && i != j)
+                sink(j, i, skew ? T(-v) : v);
+        };
+
+        string buf;
+        size_t done = 0;
+        vector<size_t> cuts, counts;
+        for (bool eof = false; !eof;) {
+            //     ( )  
+            const size_t tail = buf.size();
+            buf.resize(tail + CHUNK);
+            istr.read(&buf[tail], streamsize(CHUNK));
+            buf.resize(tail + size_t(istr.gcount()));
+            eof = !istr;
+            size_t stop = buf.size();
+            if (!eof) {
+                const size_t nl = buf.rfind('\n');
+                if (nl == string::npos)
+                    continue;
+                stop = nl + 1;
+            }
+
+            //        
+            const size_t parts = std::max<size_t>(1, std::min(TThreadPool::threads(), stop / SPARSE_GRAIN));
+            cuts.assign(parts + 1, stop);
+            cuts[0] = 0;
+            for (size_t t = 1; t < parts; ++t) {
+                const size_t nl = buf.find('\n', std::max(cuts[t - 1], stop / parts * t));
+                cuts[t] = nl == string::npos || nl >= stop ? stop : nl + 1;
+            }
+            counts.assign(parts + 1, 0);
+            const char* base = buf.data();
+            auto for_lines = [&](size_t t, auto body) {
+                const char* p = base + cuts[t];
+                const char* const end = base + cuts[t + 1];
+                while (p < end) {
+                    const char* eol = static_cast<const char*>(memchr(p, '\n', size_t(end - p)));
+                    if (eol == nullptr)
+                        eol = end;
+                    if (!skip_line(p, eol))
+                        body(p, eol);
+                    p = eol + 1;
+                }
+            };
+
+            //          
+            // ,       
+            if (!coordinate) {
+                TThreadPool::parallel_for(parts, [&](size_t t) {
+                    size_t n = 0;
+                    for_lines(t, [&](const char*, const char*) { ++n; });
+                    counts[t + 1] = n;
+                });
+                std::partial_sum(counts.begin(), counts.end(), counts.begin());
+                if (done + counts.back() > h.entries)
+                    throw invalid_argument("Matrix Market entry count does not match the header");
+            }
+            TThreadPool::parallel_for(parts, [&](size_t t) {
+                size_t n = 0;
+                if (coordinate) {
+                    for_lines(t, [&](const char* p, const char* eol) {
+                        size_t i, j;
+                        T v;
+                        p = parse(p, eol, i);
+                        p = parse(p, eol, j);
+                        p = parse_value(p, eol, h.field, v);
+                        if (!skip_line(p, eol))
+                            throw invalid_argument("Malformed Matrix Market entry");
+                        if (i == 0 || j == 0 || i > h.rows || j > h.cols)
+                            throw out_of_range("Matrix Market entry index out of range");
+                        emit(i - 1, j - 1, v);
+                        ++n;
+                    });
+                    counts[t + 1] = n;
+                    return;
+                }
+                TArrayPos pos(h, done + counts[t]);
+                for_lines(t, [&](const char* p, const char* eol) {
+                    T v;
+                    p = parse_value(p, eol, h.field, v);
+                    if (!skip_line(p, eol))
+                        throw invalid_argument("Malformed Matrix Market entry");
+                    emit(pos.i, pos.j, v);
+                    pos.next();
+                });
+            });
+            if (coordinate)
+                std::partial_sum(counts.begin(), counts.end(), counts.begin());
+            done += counts.back();
+            buf.erase(0, stop);
+        }
+        if (done != h.entries)
+            throw invalid_argument("Matrix Market entry count does not match the header");
+    }
+
+    template<typename T>
+    static void check_type()
+    {
+        static_assert(is_arithmetic<T>::value, "Matrix Market I/O needs an arithmetic element type");
+    }
+
+    template<typename T>
+    static void write_value(ostream& ostr, const T& v)
+    {
+        char buf[64];
+        const to_chars_result r = std::to_chars(buf, buf + sizeof(buf), v);
+        ostr.write(buf, r.ptr - buf);
+    }
+
+    template<typename T>
+    static const char* field_name() noexcept
+    {
+        return is_integral<T>::value ? "integer" : "real";
+    }
+
+public:
+    //    ;     
+    static TMtxHeader read_header(istream& istr)
+    {
+        string line;
+        if (!getline(istr, line))
+            throw invalid_argument("Empty Matrix Market stream");
+        istringstream banner(line);
+        string magic, object, format, field, symmetry;
+        banner >> magic >> object >> format >> field >> symmetry;
+        if (magic != "%%MatrixMarket" || lower(object) != "matrix")
+            throw invalid_argument("Not a Matrix Market matrix");
+
+        TMtxHeader h;
+        format = lower(format);
+        field = lower(field);
+        symmetry = lower(symmetry);
+        if (format == "coordinate") h.format = TMtxHeader::Format::Coordinate;
+        else if (format == "array") h.format = TMtxHeader::Format::Array;
+        else throw invalid_argument("Unsupported Matrix Market format");
+        if (field == "real" || field == "double") h.field = TMtxHeader::Field::Real;
+        else if (field == "integer") h.field = TMtxHeader::Field::Integer;
+        else if (field == "pattern" && h.format == TMtxHeader::Format::Coordinate) h.field = TMtxHeader::Field::Pattern;
+        else throw invalid_argument("Unsupported Matrix Market field");
+        if (symmetry == "general") h.symmetry = TMtxHeader::Symmetry::General;
+        else if (symmetry == "symmetric") h.symmetry = TMtxHeader::Symmetry::Symmetric;
+        else if (symmetry == "skew-symmetric") h.symmetry = TMtxHeader::Symmetry::SkewSymmetric;
+        else throw invalid_argument("Unsupported Matrix Market symmetry");
+
+        while (getline(istr, line) && skip_line(line.data(), line.data() + line.size()))
+            ;
+        istringstream sizes(line);
+        sizes >> h.rows >> h.cols;
+        if (h.format == TMtxHeader::Format::Coordinate) {
+            sizes >> h.entries;
+        }
+        else {
+            const size_t n = h.rows;
+            h.entries = h.symmetry == TMtxHeader::Symmetry::General ? h.rows * h.cols
+                      : h.symmetry == TMtxHeader::Symmetry::Symmetric ? n * (n + 1) / 2 : n * (n - 1) / 2;
+        }
+        if (!sizes || h.rows == 0 || h.cols == 0)
+            throw invalid_argument("Malformed Matrix Market size line");
+        if (h.symmetry != TMtxHeader::Symmetry::General && h.rows != h.cols)
+            throw invalid_argument("Symmetric Matrix Market matrix must be square");
+        return h;
+    }
+
+    //     CSR   ;
+    //     ,
+    //     
+    template<typename T>
+    static TSparseMatrixCSR<T> read_sparse(istream& istr)
+    {
+        check_type<T>();
+        const TMtxHeader h = read_header(istr);
+        const bool coordinate = h.format == TMtxHeader::Format::Coordinate;
+        TSparseBuilder<T> builder(h.rows, h.cols);
+        read_body<T>(istr, h, [&](size_t i, size_t j, const T& v) {
+            if (coordinate || v != T())
+                builder.add(i, j, v);
+        });
+        return builder.build();
+    }
+
+    //      ;  
+    //    (  (i, j), (j, i)  )
+    //  :       ,
+    //    ,       
+    template<typename T>
+    static TDynamicMatrix<T> read_dense(istream& istr)
+    {
+        check_type<T>();
+        const TMtxHeader h = read_header(istr);
+        if (h.rows != h.cols)
+            throw invalid_argument("Only square Matrix Market matrices read into TDynamicMatrix");
+        TDynamicMatrix<T> m(h.rows);
+        if (h.format == TMtxHeader::Format::Array) {
+            read_body<T>(istr, h, [&](size_t i, size_t j, const T& v) { m[i][j] = v; });
+            return m;
+        }
+        vector<atomic<uint64_t>> seen((h.rows * h.cols + 63) / 64);
+        read_body<T>(istr, h, [&](size_t i, size_t j, const T& v) {
+            const size_t pos = i * h.cols + j;
+            const uint64_t bit = uint64_t(1) << (pos % 64);
+            if (seen[pos / 64].fetch_or(bit, memory_order_relaxed) & bit)
+                throw invalid_argument("Duplicate Matrix Market entry");
+            m[i][j] = v;
+        });
+        return m;
+    }
+
+    //  ; symmetric = true   
+    // ,      
+    template<typename T>
+    static void write(ostream& ostr, const TSparseMatrixCSR<T>& m, bool symmetric = false)
+    {
+        check_type<T>();
+        if (symmetric && m.rows() != m.cols())
+            throw invalid_argument("Symmetric Matrix Market matrix must be square");
+
+        const vector<size_t>& rp = m.row_ptr();
+        const auto& ci = m.col_idx();
+        const vector<T>& va = m.values();
+        size_t entries = m.nnz();
+        if (symmetric) {
+            entries = 0;
+            for (size_t i = 0; i < m.rows(); ++i)
+                for (size_t k = rp[i]; k < rp[i + 1] && ci[k] <= i; ++k)
+                    ++entries;
+        }
+        ostr << "%%MatrixMarket matrix coordinate " << field_name<T>() << (symmetric ? " symmetric\n" : " general\n");
+        ostr << m.rows() << ' ' << m.cols() << ' ' << entries << '\n';
+        for (size_t i = 0; i < m.rows(); ++i)
+            for (size_t k = rp[i]; k < rp[i + 1] && (!symmetric || ci[k] <= i); ++k) {
+                write_value(ostr, i + 1);
+                ostr.put(' ');
+                write_value(ostr, size_t(ci[k]) + 1);
+                ostr.put(' ');
+                write_value(ostr, va[k]);
+                ostr.put('\n');
+            }
+    }
+
+    //  ,   
+    template<typename T>
+    static void write(ostream& ostr, const TDynamicMatrix<T>& m)
+    {
+        check_type<T>();
+        ostr << "%%MatrixMarket matrix array " << field_name<T>() << " general\n";
+        ostr << m.size() << ' ' << m.size() << '\n';
+        for (size_t j = 0; j < m.size(); ++j)
+            for (size_t i = 0; i < m.size(); ++i) {
+                write_value(ostr, m[i][j]);
+                ostr.put('\n');
+            }
+    }
+};
+
+#endif
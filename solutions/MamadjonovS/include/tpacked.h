@@ -0,0 +1,226 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//       (  )
+
+#ifndef __TPacked_H__
+#define __TPacked_H__
+
+#include "tmatrix.h"
+
+using namespace std;
+
+//    -
+//     :  [first, last)
+template<typename U>
+class TPackedRow
+{
+    U* pRow;
+    size_t first;
+    size_t last;
+public:
+    using value_type = typename remove_const<U>::type;
+
+    TPackedRow(U* row, size_t f, size_t l) noexcept : pRow(row), first(f), last(l) {}
+
+    size_t begin_col() const noexcept { return first; }
+    size_t end_col() const noexcept { return last; }
+    U* data() const noexcept { return pRow; }
+
+    //       
+    U& operator[](size_t col) const
+    {
+        return pRow[col - first];
+    }
+
+    //   
+    U& at(size_t col) const
+    {
+        if (col < first || col >= last)
+            throw out_of_range("Column index is outside the stored triangle");
+        return pRow[col - first];
+    }
+};
+
+
+//   -
+//  D::packed_size(n)     ; 
+//    D.   (+, -, 
+//  )       ,
+//      
+template<typename D, typename T>
+class TPackedMatrix : public TExpr<D>
+{
+protected:
+    size_t sz;
+    T* pMem;
+
+    size_t count() const noexcept { return D::packed_size(sz); }
+
+    //  :   
+    struct no_init_t {};
+    static constexpr no_init_t no_init = {};
+
+    TPackedMatrix(size_t s, no_init_t) : sz(s)
+    {
+        pMem = new T[count()];
+    }
+
+    explicit TPackedMatrix(size_t s) : sz(s)
+    {
+        if (sz == 0)
+            throw out_of_range("Matrix size should be greater than zero");
+        if (sz > MAX_MATRIX_SIZE)
+            throw out_of_range("Matrix size exceeds maximum allowed");
+        pMem = new T[count()]();
+    }
+
+    TPackedMatrix(const TPackedMatrix& m) : sz(m.sz)
+    {
+        pMem = new T[count()];
+        std::copy(m.pMem, m.pMem + count(), pMem);
+    }
+
+    TPackedMatrix(TPackedMatrix&& m) noexcept : sz(m.sz), pMem(m.pMem)
+    {
+        m.sz = 0;
+        m.pMem = nullptr;
+    }
+
+    ~TPackedMatrix()
+    {
+        delete[] pMem;
+        pMem = nullptr;
+        sz = 0;
+    }
+
+    TPackedMatrix& operator=(const TPackedMatrix& m)
+    {
+        if (this == &m) return *this;
+
+        if (sz != m.sz) {
+            TPackedMatrix tmp(m);
+            swap(*this, tmp);
+            return *this;
+        }
+        std::copy(m.pMem, m.pMem + count(), pMem);
+        return *this;
+    }
+
+    TPackedMatrix& operator=(TPackedMatrix&& m) noexcept
+    {
+        if (this == &m) return *this;
+
+        TPackedMatrix tmp(std::move(m));
+        swap(*this, tmp);
+        return *this;
+    }
+
+    D& derived() noexcept { return static_cast<D&>(*this); }
+    const D& derived() const noexcept { return static_cast<const D&>(*this); }
+
+public:
+    using container = D;
+    using value_type = T;
+    static constexpr bool is_leaf = true;
+
+    template<typename E, typename = TExprSameKind<E, TPackedMatrix>>
+    D& operator=(const TExpr<E>& e)
+    {
+        const E& x = e.self();
+        if (sz != x.size()) {
+            D tmp(x);
+            swap(*this, tmp);
+            return derived();
+        }
+        expr_assign(x, pMem, x.expr_references(pMem));
+        return derived();
+    }
+
+    size_t size() const noexcept { return sz; }
+
+    //     :    
+    size_t expr_length() const noexcept { return count(); }
+    const T* expr_direct(size_t first) const noexcept { return pMem + first; }
+    void expr_eval(size_t first, size_t n, T* out) const { std::copy(pMem + first, pMem + first + n, out); }
+    bool expr_references(const void* p) const noexcept { return p == pMem; }
+
+    bool operator==(const D& m) const noexcept
+    {
+        return sz == m.sz && std::equal(pMem, pMem + count(), m.pMem);
+    }
+
+    bool operator!=(const D& m) const noexcept
+    {
+        return !(*this == m);
+    }
+
+    //  
+    template<typename E, typename = TExprSameKind<E, TPackedMatrix>>
+    D& operator+=(const TExpr<E>& m)
+    {
+        if (sz != m.self().size())
+            throw invalid_argument("Matrix sizes must be equal for addition");
+
+        expr_compound<TExprAdd>(m.self(), pMem);
+        return derived();
+    }
+
+    template<typename E, typename = TExprSameKind<E, TPackedMatrix>>
+    D& operator-=(const TExpr<E>& m)
+    {
+        if (sz != m.self().size())
+            throw invalid_argument("Matrix sizes must be equal for subtraction");
+
+        expr_compound<TExprSub>(m.self(), pMem);
+        return derived();
+    }
+
+    D& operator*=(const T& val)
+    {
+        TVectorKernels<T>::mul_scalar(pMem, val, pMem, count());
+        return derived();
+    }
+
+    //   ;        
+    TExprScalar<D, TExprMul> operator*(const T& val) const&
+    {
+        return TExprScalar<D, TExprMul>(derived(), val);
+    }
+
+    D operator*(const T& val) &&
+    {
+        *this *= val;
+        return std::move(derived());
+    }
+
+    friend void swap(TPackedMatrix& lhs, TPackedMatrix& rhs) noexcept
+    {
+        std::swap(lhs.sz, rhs.sz);
+        std::swap(lhs.pMem, rhs.pMem);
+    }
+
+    // /:       
+    friend istream& operator>>(istream& istr, TPackedMatrix& m)
+    {
+        for (size_t i = 0; i < m.count(); ++i)
+            istr >> m.pMem[i];
+        return istr;
+    }
+
+    friend ostream& operator<<(ostream& ostr, const TPackedMatrix& m)
+    {
+        ostr << D::kind_name() << " matrix " << m.sz << "x" << m.sz << ":\n";
+        for (size_t i = 0; i < m.sz; ++i) {
+            ostr << "  [ ";
+            for (size_t j = 0; j < m.sz; ++j) {
+                ostr << setw(6) << m.derived().get(i, j);
+            }
+            ostr << " ]\n";
+        }
+        return ostr;
+    }
+};
+
+#endif
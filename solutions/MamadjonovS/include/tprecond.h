@@ -0,0 +1,335 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+// :     ILU(0), ILUT, IC(0)
+
+#ifndef __TPrecond_H__
+#define __TPrecond_H__
+
+#include <algorithm>
+#include <cmath>
+
+#include "tsptrsv.h"
+
+using namespace std;
+
+//   -
+// z = D^-1 r,  D -  A;    
+template<typename T>
+class TJacobi
+{
+    TDynamicVector<T> inv;
+
+public:
+    explicit TJacobi(const TSparseMatrixCSR<T>& a) : inv(a.rows())
+    {
+        if (a.rows() != a.cols())
+            throw invalid_argument("Jacobi preconditioner needs a square matrix");
+        for (size_t i = 0; i < a.rows(); ++i) {
+            const T d = a.get(i, i);
+            if (d == T())
+                throw invalid_argument("Jacobi preconditioner needs nonzero diagonal");
+            inv[i] = T(1) / d;
+        }
+    }
+
+    size_t size() const noexcept { return inv.size(); }
+
+    // z  r    
+    void apply(const TDynamicVector<T>& r, TDynamicVector<T>& z) const
+    {
+        if (r.size() != size() || z.size() != size())
+            throw invalid_argument("Vector sizes must match the preconditioner");
+        const T* pr = r.data();
+        const T* pd = inv.data();
+        T* pz = z.data();
+        TThreadPool::parallel_blocks(size(), EXPR_GRAIN, [&](size_t begin, size_t end) {
+            TVectorKernels<T>::mul(pd + begin, pr + begin, pz + begin, end - begin);
+        });
+    }
+};
+
+//  LU -
+// L ( ,  )  U ( )  
+//  CSR- lu; apply()  L y = r  U z = y  
+//    .    apply()  
+// ,  apply()   .   ILU(0)  ILUT
+template<typename T>
+class TIncompleteLU
+{
+protected:
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+
+    TSparseMatrixCSR<T> lu;
+    TSpTrsv<T> lower, upper;
+
+    explicit TIncompleteLU(TSparseMatrixCSR<T> factors)
+        : lu(std::move(factors)),
+          lower(lu, TSpTrsv<T>::Triangle::Lower, true),
+          upper(lu, TSpTrsv<T>::Triangle::Upper)
+    {
+    }
+
+public:
+    size_t size() const noexcept { return lu.rows(); }
+
+    // L  U   ;  L  
+    const TSparseMatrixCSR<T>& factors() const noexcept { return lu; }
+
+    // z = (LU)^-1 r; z  r    
+    void apply(const TDynamicVector<T>& r, TDynamicVector<T>& z) const
+    {
+        lower.solve(lu, r, z);
+        upper.solve(lu, z, z);
+    }
+};
+
+// ILU(0) -
+//      A ( ),  IKJ:
+//  i   j < i,     
+template<typename T>
+class TIlu0 : public TIncompleteLU<T>
+{
+    using typename TIncompleteLU<T>::index_type;
+
+    static TSparseMatrixCSR<T> factorize(const TSparseMatrixCSR<T>& a)
+    {
+        if (a.rows() != a.cols())
+            throw invalid_argument("Incomplete factorization needs a square matrix");
+
+        const size_t n = a.rows();
+        const vector<size_t>& rp = a.row_ptr();
+        const vector<index_type>& ci = a.col_idx();
+        vector<T> v(a.values());
+        vector<size_t> diag(n), pos(n, size_t(-1));
+        for (size_t i = 0; i < n; ++i) {
+            diag[i] = size_t(std::lower_bound(ci.begin() + rp[i], ci.begin() + rp[i + 1], index_type(i)) - ci.begin());
+            if (diag[i] == rp[i + 1] || ci[diag[i]] != i)
+                throw invalid_argument("Incomplete factorization needs all diagonal elements");
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = rp[i]; k < rp[i + 1]; ++k)
+                pos[ci[k]] = k;
+            for (size_t k = rp[i]; k < diag[i]; ++k) {
+                const size_t j = ci[k];
+                v[k] /= v[diag[j]];
+                for (size_t q = diag[j] + 1; q < rp[j + 1]; ++q)
+                    if (pos[ci[q]] != size_t(-1))
+                        v[pos[ci[q]]] -= v[k] * v[q];
+            }
+            if (v[diag[i]] == T())
+                throw invalid_argument("Zero pivot in incomplete factorization");
+            for (size_t k = rp[i]; k < rp[i + 1]; ++k)
+                pos[ci[k]] = size_t(-1);
+        }
+        TSparseMatrixCSR<T> f(a);
+        f.set_values(std::move(v));
+        return f;
+    }
+
+public:
+    explicit TIlu0(const TSparseMatrixCSR<T>& a) : TIncompleteLU<T>(factorize(a)) {}
+};
+
+// ILUT(tol, p) -
+//  i        
+// U     (  ),   
+//    .   
+// tol * ||a_i||,   L  U     p 
+template<typename T>
+class TIlut : public TIncompleteLU<T>
+{
+    using typename TIncompleteLU<T>::index_type;
+
+    //   (cols, vals)   p    
+    //     
+    static void keep_largest(vector<pair<index_type, T>>& row, size_t p)
+    {
+        if (row.size() > p) {
+            std::nth_element(row.begin(), row.begin() + p, row.end(),
+                [](const pair<index_type, T>& x, const pair<index_type, T>& y) { return std::abs(x.second) > std::abs(y.second); });
+            row.resize(p);
+        }
+        std::sort(row.begin(), row.end(),
+                  [](const pair<index_type, T>& x, const pair<index_type, T>& y) { return x.first < y.first; });
+    }
+
+    static TSparseMatrixCSR<T> factorize(const TSparseMatrixCSR<T>& a, T tol, size_t p)
+    {
+        if (a.rows() != a.cols())
+            throw invalid_argument("Incomplete factorization needs a square matrix");
+
+        const size_t n = a.rows();
+        const vector<size_t>& arp = a.row_ptr();
+        const vector<index_type>& aci = a.col_idx();
+        const vector<T>& ava = a.values();
+
+        vector<size_t> rp(n + 1, 0), diag(n);
+        vector<index_type> ci;
+        vector<T> va;
+        vector<T> w(n, T());
+        vector<char> used(n, 0);
+        vector<index_type> pattern;
+        vector<index_type> heap;
+        vector<pair<index_type, T>> lrow, urow;
+        auto greater = [](index_type x, index_type y) { return x > y; };
+
+        for (size_t i = 0; i < n; ++i) {
+            T norm = T();
+            pattern.clear();
+            heap.clear();
+            for (size_t k = arp[i]; k < arp[i + 1]; ++k) {
+                const index_type j = aci[k];
+                w[j] = ava[k];
+                used[j] = 1;
+                pattern.push_back(j);
+                norm += ava[k] * ava[k];
+                if (j < i)
+                    heap.push_back(j);
+            }
+            norm = std::sqrt(norm / T(std::max<size_t>(1, arp[i + 1] - arp[i])));
+            const T drop = tol * norm;
+            std::make_heap(heap.begin(), heap.end(), greater);
+
+            lrow.clear();
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), greater);
+                const size_t k = heap.back();
+                heap.pop_back();
+                T l = w[k] / va[diag[k]];
+                w[k] = T();
+                if (std::abs(l) < drop)
+                    continue;
+                lrow.push_back({ index_type(k), l });
+                for (size_t q = diag[k] + 1; q < rp[k + 1]; ++q) {
+                    const index_type j = ci[q];
+                    if (!used[j]) {
+                        used[j] = 1;
+                        pattern.push_back(j);
+                        if (j < i) {
+                            heap.push_back(j);
+                            std::push_heap(heap.begin(), heap.end(), greater);
+                        }
+                    }
+                    w[j] -= l * va[q];
+                }
+            }
+
+            urow.clear();
+            T d = T();
+            for (index_type j : pattern) {
+                if (j == i)
+                    d = w[j];
+                else if (j > i && std::abs(w[j]) >= drop && w[j] != T())
+                    urow.push_back({ j, w[j] });
+                w[j] = T();
+                used[j] = 0;
+            }
+            keep_largest(lrow, p);
+            keep_largest(urow, p);
+            //     ,   
+            if (d == T())
+                d = (T(1e-4) + tol) * (norm == T() ? T(1) : norm);
+
+            for (const auto& e : lrow) {
+                ci.push_back(e.first);
+                va.push_back(e.second);
+            }
+            diag[i] = ci.size();
+            ci.push_back(index_type(i));
+            va.push_back(d);
+            for (const auto& e : urow) {
+                ci.push_back(e.first);
+                va.push_back(e.second);
+            }
+            rp[i + 1] = ci.size();
+        }
+        return TSparseMatrixCSR<T>(n, n, std::move(rp), std::move(ci), std::move(va));
+    }
+
+public:
+    // tol -   , p -  
+    //   L   U  
+    TIlut(const TSparseMatrixCSR<T>& a, T tol, size_t p) : TIncompleteLU<T>(factorize(a, tol, p)) {}
+};
+
+// IC(0) -
+//    A ~ L L^T   
+//     .
+// L^T   ( ),  
+//     
+template<typename T>
+class TIc0
+{
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+
+    TSparseMatrixCSR<T> l, lt;
+    TSpTrsv<T> lower, upper;
+
+    static TSparseMatrixCSR<T> factorize(const TSparseMatrixCSR<T>& a)
+    {
+        if (a.rows() != a.cols())
+            throw invalid_argument("Incomplete factorization needs a square matrix");
+
+        //   A
+        const size_t n = a.rows();
+        vector<size_t> rp(n + 1, 0);
+        vector<index_type> ci;
+        vector<T> va;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = a.row_ptr()[i]; k < a.row_ptr()[i + 1] && a.col_idx()[k] <= i; ++k) {
+                ci.push_back(a.col_idx()[k]);
+                va.push_back(a.values()[k]);
+            }
+            if (ci.empty() || rp[i] == ci.size() || ci.back() != i)
+                throw invalid_argument("Incomplete factorization needs all diagonal elements");
+            rp[i + 1] = ci.size();
+        }
+
+        // l_ij = (a_ij - sum_{m<j} l_im l_jm) / l_jj, l_ii = sqrt(a_ii - sum l_im^2);
+        //  i   ,   -   pos
+        vector<size_t> pos(n, size_t(-1));
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = rp[i]; k < rp[i + 1]; ++k)
+                pos[ci[k]] = k;
+            for (size_t k = rp[i]; k + 1 < rp[i + 1]; ++k) {
+                const size_t j = ci[k];
+                T s = va[k];
+                for (size_t q = rp[j]; q + 1 < rp[j + 1]; ++q)
+                    if (pos[ci[q]] != size_t(-1))
+                        s -= va[pos[ci[q]]] * va[q];
+                va[k] = s / va[rp[j + 1] - 1];
+            }
+            T d = va[rp[i + 1] - 1];
+            for (size_t k = rp[i]; k + 1 < rp[i + 1]; ++k)
+                d -= va[k] * va[k];
+            if (!(d > T()))
+                throw invalid_argument("Matrix is not positive definite for IC(0)");
+            va[rp[i + 1] - 1] = std::sqrt(d);
+            for (size_t k = rp[i]; k < rp[i + 1]; ++k)
+                pos[ci[k]] = size_t(-1);
+        }
+        return TSparseMatrixCSR<T>(n, n, std::move(rp), std::move(ci), std::move(va));
+    }
+
+public:
+    explicit TIc0(const TSparseMatrixCSR<T>& a)
+        : l(factorize(a)), lt(l.transpose()),
+          lower(l, TSpTrsv<T>::Triangle::Lower), upper(lt, TSpTrsv<T>::Triangle::Upper)
+    {
+    }
+
+    size_t size() const noexcept { return l.rows(); }
+    const TSparseMatrixCSR<T>& factor() const noexcept { return l; }
+
+    // z = (L L^T)^-1 r; z  r    
+    void apply(const TDynamicVector<T>& r, TDynamicVector<T>& z) const
+    {
+        lower.solve(l, r, z);
+        upper.solve(lt, z, z);
+    }
+};
+
+#endif
@@ -0,0 +1,225 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//   ,   
+
+#ifndef __TReorder_H__
+#define __TReorder_H__
+
+#include <algorithm>
+#include <numeric>
+
+#include "tsparse.h"
+
+using namespace std;
+
+//  -
+// p[k] -   ,   k-.  
+//  ,       -  
+class TPermutation
+{
+    vector<size_t> perm, inv;
+
+public:
+    //  
+    explicit TPermutation(size_t n = 1) : perm(n), inv(n)
+    {
+        std::iota(perm.begin(), perm.end(), size_t(0));
+        std::iota(inv.begin(), inv.end(), size_t(0));
+    }
+
+    explicit TPermutation(vector<size_t> p) : perm(std::move(p)), inv(perm.size(), perm.size())
+    {
+        for (size_t k = 0; k < perm.size(); ++k) {
+            if (perm[k] >= perm.size() || inv[perm[k]] != perm.size())
+                throw invalid_argument("Not a permutation");
+            inv[perm[k]] = k;
+        }
+    }
+
+    size_t size() const noexcept { return perm.size(); }
+
+    //   k-      i-
+    size_t operator[](size_t k) const noexcept { return perm[k]; }
+    size_t position(size_t i) const noexcept { return inv[i]; }
+
+    const vector<size_t>& order() const noexcept { return perm; }
+
+    TPermutation inverse() const
+    {
+        return TPermutation(inv);
+    }
+
+    bool operator==(const TPermutation& p) const noexcept { return perm == p.perm; }
+    bool operator!=(const TPermutation& p) const noexcept { return perm != p.perm; }
+
+    // y[k] = x[p[k]]
+    template<typename T>
+    TDynamicVector<T> apply(const TDynamicVector<T>& x) const
+    {
+        if (x.size() != size())
+            throw invalid_argument("Permutation and vector sizes must be equal");
+        TDynamicVector<T> y(size());
+        const T* px = x.data();
+        T* py = y.data();
+        TThreadPool::parallel_blocks(size(), EXPR_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+                py[k] = px[perm[k]];
+        });
+        return y;
+    }
+
+    //  : y[p[k]] = x[k]
+    template<typename T>
+    TDynamicVector<T> apply_inverse(const TDynamicVector<T>& x) const
+    {
+        if (x.size() != size())
+            throw invalid_argument("Permutation and vector sizes must be equal");
+        TDynamicVector<T> y(size());
+        const T* px = x.data();
+        T* py = y.data();
+        TThreadPool::parallel_blocks(size(), EXPR_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+                py[perm[k]] = px[k];
+        });
+        return y;
+    }
+
+    //   P A P^T:  (p[i], p[j])  (i, j).
+    //   ,    
+    //       
+    template<typename T>
+    TSparseMatrixCSR<T> apply(const TSparseMatrixCSR<T>& a) const
+    {
+        if (a.rows() != size() || a.cols() != size())
+            throw invalid_argument("Permutation size must match the square matrix");
+
+        using index_type = typename TSparseMatrixCSR<T>::index_type;
+        const vector<size_t>& rp = a.row_ptr();
+        const vector<index_type>& ci = a.col_idx();
+        const vector<T>& va = a.values();
+        vector<size_t> row_ptr(size() + 1, 0);
+        for (size_t k = 0; k < size(); ++k)
+            row_ptr[k + 1] = row_ptr[k] + rp[perm[k] + 1] - rp[perm[k]];
+        vector<index_type> col_idx(a.nnz());
+        vector<T> values(a.nnz());
+
+        const size_t grain = std::max<size_t>(1, SPARSE_GRAIN / std::max<size_t>(1, a.nnz() / size()));
+        TThreadPool::parallel_blocks(size(), grain, [&](size_t begin, size_t end) {
+            vector<pair<index_type, T>> row;
+            for (size_t k = begin; k < end; ++k) {
+                row.clear();
+                for (size_t q = rp[perm[k]]; q < rp[perm[k] + 1]; ++q)
+                    row.push_back({ index_type(inv[ci[q]]), va[q] });
+                std::sort(row.begin(), row.end(),
+                          [](const pair<index_type, T>& x, const pair<index_type, T>& y) { return x.first < y.first; });
+                for (size_t q = 0; q < row.size(); ++q) {
+                    col_idx[row_ptr[k] + q] = row[q].first;
+                    values[row_ptr[k] + q] = row[q].second;
+                }
+            }
+        });
+        return TSparseMatrixCSR<T>(size(), size(), std::move(row_ptr), std::move(col_idx), std::move(values));
+    }
+};
+
+//  :  |i - j|   
+template<typename T>
+size_t bandwidth(const TSparseMatrixCSR<T>& a)
+{
+    size_t b = 0;
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t k = a.row_ptr()[i]; k < a.row_ptr()[i + 1]; ++k) {
+            const size_t j = a.col_idx()[k];
+            b = std::max(b, i > j ? i - j : j - i);
+        }
+    return b;
+}
+
+//    -  -
+//       A + A^T,   
+//    ;   
+//     ( - ),  
+//  .  -   TPermutation::apply
+template<typename T>
+TPermutation reverse_cuthill_mckee(const TSparseMatrixCSR<T>& a)
+{
+    if (a.rows() != a.cols())
+        throw invalid_argument("Reordering needs a square matrix");
+
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+    const size_t n = a.rows();
+    const TSparseMatrixCSR<T> g = a + a.transpose();
+    const vector<size_t>& rp = g.row_ptr();
+    const vector<index_type>& ci = g.col_idx();
+    auto degree = [&](size_t v) { return rp[v + 1] - rp[v]; };
+
+    vector<size_t> order;
+    order.reserve(n);
+    vector<char> placed(n, 0);
+    vector<size_t> mark(n, 0), queue, dist, neighbours;
+    size_t stamp = 0;
+
+    //     root   : queue - 
+    //   , dist -  ;  
+    auto bfs = [&](size_t root) {
+        queue.assign(1, root);
+        dist.assign(1, 0);
+        mark[root] = ++stamp;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const size_t v = queue[head];
+            for (size_t k = rp[v]; k < rp[v + 1]; ++k) {
+                const size_t u = ci[k];
+                if (!placed[u] && mark[u] != stamp) {
+                    mark[u] = stamp;
+                    queue.push_back(u);
+                    dist.push_back(dist[head] + 1);
+                }
+            }
+        }
+        return dist.back();
+    };
+
+    vector<size_t> by_degree(n);
+    std::iota(by_degree.begin(), by_degree.end(), size_t(0));
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&](size_t x, size_t y) { return degree(x) < degree(y); });
+    for (size_t start : by_degree) {
+        if (placed[start])
+            continue;
+
+        //  :    
+        //     ,   
+        size_t root = start, depth = bfs(root);
+        for (;;) {
+            size_t best = queue.back();
+            for (size_t h = 0; h < queue.size(); ++h)
+                if (dist[h] == depth && degree(queue[h]) < degree(best))
+                    best = queue[h];
+            const size_t d = bfs(best);
+            if (d <= depth)
+                break;
+            root = best;
+            depth = d;
+        }
+
+        queue.assign(1, root);
+        placed[root] = 1;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const size_t v = queue[head];
+            order.push_back(v);
+            neighbours.clear();
+            for (size_t k = rp[v]; k < rp[v + 1]; ++k)
+                if (!placed[ci[k]]) {
+                    placed[ci[k]] = 1;
+                    neighbours.push_back(ci[k]);
+                }
+            std::stable_sort(neighbours.begin(), neighbours.end(), [&](size_t x, size_t y) { return degree(x) < degree(y); });
+            queue.insert(queue.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return TPermutation(std::move(order));
+}
+
+#endif
@@ -0,0 +1,284 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//     SELL-C-sigma
+
+#ifndef __TSell_H__
+#define __TSell_H__
+
+#include <algorithm>
+#include <numeric>
+
+#include "tsparse.h"
+
+using namespace std;
+
+//  SpMV   [begin, end) -
+//   C    :  j  j-  
+//  C  ,    .  r
+//   k   y[perm[k * C + r]],    
+//    (perm == nrows).  ( j >= lens[k * C + r])
+//    ,   NaN   x    
+template<typename T, size_t C>
+void sell_kernel_ref(const T* vals, const uint32_t* cols, const size_t* chunk_ptr, const uint32_t* perm,
+                     const uint32_t* lens, size_t begin, size_t end, const T* x, T* y, size_t nrows)
+{
+    for (size_t k = begin; k < end; ++k) {
+        T acc[C] = {};
+        const size_t width = (chunk_ptr[k + 1] - chunk_ptr[k]) / C;
+        const T* v = vals + chunk_ptr[k];
+        const uint32_t* c = cols + chunk_ptr[k];
+        const uint32_t* len = lens + k * C;
+        for (size_t j = 0; j < width; ++j, v += C, c += C)
+            for (size_t r = 0; r < C; ++r)
+                if (j < len[r])
+                    acc[r] += v[r] * x[c[r]];
+        for (size_t r = 0; r < C; ++r)
+            if (perm[k * C + r] < nrows)
+                y[perm[k * C + r]] = acc[r];
+    }
+}
+
+#ifdef TMATRIX_X86
+//   -
+// C     C / W  :   ,
+//  gather  x   FMA    ,   .
+//       gather ,  -  
+//   ,    x  
+template<typename V, size_t C>
+struct TSellKernel
+{
+    using T = typename V::elem;
+    using vec = typename V::vec;
+    static constexpr size_t NV = C / V::W;
+
+    static void run(const T* vals, const uint32_t* cols, const size_t* chunk_ptr, const uint32_t* perm,
+                    const uint32_t* lens, size_t begin, size_t end, const T* x, T* y, size_t nrows)
+    {
+        for (size_t k = begin; k < end; ++k) {
+            vec acc[NV];
+#pragma GCC unroll 4
+            for (size_t q = 0; q < NV; ++q)
+                V::zero(acc[q]);
+            const size_t width = (chunk_ptr[k + 1] - chunk_ptr[k]) / C;
+            const T* v = vals + chunk_ptr[k];
+            const uint32_t* c = cols + chunk_ptr[k];
+            const uint32_t* len = lens + k * C;
+            const size_t full = *std::min_element(len, len + C);
+            size_t j = 0;
+            for (; j < full; ++j, v += C, c += C) {
+#pragma GCC unroll 4
+                for (size_t q = 0; q < NV; ++q) {
+                    vec a, g;
+                    V::load(a, v + q * V::W);
+                    V::gather(g, x, c + q * V::W);
+                    V::fmadd(acc[q], a, g);
+                }
+            }
+            for (; j < width; ++j, v += C, c += C) {
+#pragma GCC unroll 4
+                for (size_t q = 0; q < NV; ++q) {
+                    vec a, g;
+                    V::load(a, v + q * V::W);
+                    V::gather_live(g, x, c + q * V::W, len + q * V::W, uint32_t(j));
+                    V::fmadd(acc[q], a, g);
+                }
+            }
+            T lanes[C];
+#pragma GCC unroll 4
+            for (size_t q = 0; q < NV; ++q)
+                V::store(lanes + q * V::W, acc[q]);
+            for (size_t r = 0; r < C; ++r)
+                if (perm[k * C + r] < nrows)
+                    y[perm[k * C + r]] = lanes[r];
+        }
+    }
+};
+#endif
+
+//   SELL -
+//   ,    C   ;
+//         
+template<typename T, size_t C>
+struct TSellKernels
+{
+    static void run(const T* vals, const uint32_t* cols, const size_t* chunk_ptr, const uint32_t* perm,
+                    const uint32_t* lens, size_t begin, size_t end, const T* x, T* y, size_t nrows)
+    {
+        sell_kernel_ref<T, C>(vals, cols, chunk_ptr, perm, lens, begin, end, x, y, nrows);
+    }
+};
+
+#ifdef TMATRIX_X86
+template<typename V2, typename V512, size_t C>
+struct TSellKernelsX86
+{
+    using T = typename V2::elem;
+
+    static void run(const T* vals, const uint32_t* cols, const size_t* chunk_ptr, const uint32_t* perm,
+                    const uint32_t* lens, size_t begin, size_t end, const T* x, T* y, size_t nrows)
+    {
+        switch (TCpu::level()) {
+        case TCpuLevel::AVX512:
+            if constexpr (C % V512::W == 0)
+                return simd_run_avx512<TSellKernel<V512, C>>(vals, cols, chunk_ptr, perm, lens, begin, end, x, y, nrows);
+            [[fallthrough]];
+        case TCpuLevel::AVX2:
+            if constexpr (C % V2::W == 0)
+                return simd_run_avx2<TSellKernel<V2, C>>(vals, cols, chunk_ptr, perm, lens, begin, end, x, y, nrows);
+            [[fallthrough]];
+        default:
+            sell_kernel_ref<T, C>(vals, cols, chunk_ptr, perm, lens, begin, end, x, y, nrows);
+        }
+    }
+};
+
+template<size_t C> struct TSellKernels<double, C> : TSellKernelsX86<TAvx2Double, TAvx512Double, C> {};
+template<size_t C> struct TSellKernels<float, C> : TSellKernelsX86<TAvx2Float, TAvx512Float, C> {};
+template<size_t C> struct TSellKernels<int, C> : TSellKernelsX86<TAvx2Int, TAvx512Int, C> {};
+#endif
+
+//   SELL-C-sigma -
+//     sigma      
+//     C ;     
+//     ,  .   
+//   ,  C    
+//   
+template<typename T, size_t C = 8>
+class TSparseMatrixSELL
+{
+    static_assert(C > 0, "Chunk height must be positive");
+
+public:
+    using index_type = uint32_t;
+    using value_type = T;
+
+private:
+    size_t nrows, ncols, window, count;
+    vector<size_t> chunkPtr;
+    vector<index_type> colIdx;
+    vector<T> vals;
+    vector<index_type> perm;
+    vector<index_type> rowLen;
+
+    size_t chunks() const noexcept { return chunkPtr.size() - 1; }
+
+public:
+    // sigma     C; sigma = C -  
+    explicit TSparseMatrixSELL(const TSparseMatrixCSR<T>& a, size_t sigma = 32 * C)
+        : nrows(a.rows()), ncols(a.cols()), window((std::max<size_t>(sigma, 1) + C - 1) / C * C), count(a.nnz())
+    {
+        const vector<size_t>& rp = a.row_ptr();
+        const size_t nchunks = (nrows + C - 1) / C;
+        perm.resize(nchunks * C);
+        rowLen.assign(nchunks * C, 0);
+        std::iota(perm.begin(), perm.begin() + nrows, index_type(0));
+        std::fill(perm.begin() + nrows, perm.end(), index_type(nrows));
+        for (size_t w = 0; w < nrows; w += window)
+            std::stable_sort(perm.begin() + w, perm.begin() + std::min(nrows, w + window),
+                [&](index_type p, index_type q) { return rp[p + 1] - rp[p] > rp[q + 1] - rp[q]; });
+
+        chunkPtr.assign(nchunks + 1, 0);
+        for (size_t k = 0; k < nchunks; ++k) {
+            size_t width = 0;
+            for (size_t r = 0; r < C; ++r) {
+                const size_t i = perm[k * C + r];
+                if (i < nrows) {
+                    rowLen[k * C + r] = index_type(rp[i + 1] - rp[i]);
+                    width = std::max<size_t>(width, rowLen[k * C + r]);
+                }
+            }
+            chunkPtr[k + 1] = chunkPtr[k] + width * C;
+        }
+
+        // :      ; 
+        //   x  ,      
+        colIdx.resize(chunkPtr.back());
+        vals.resize(chunkPtr.back());
+        const vector<index_type>& ci = a.col_idx();
+        const vector<T>& va = a.values();
+        TThreadPool::parallel_blocks(nchunks, std::max<size_t>(1, SPARSE_GRAIN / C), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const size_t width = (chunkPtr[k + 1] - chunkPtr[k]) / C;
+                for (size_t r = 0; r < C; ++r) {
+                    const size_t i = perm[k * C + r], len = rowLen[k * C + r];
+                    const size_t start = i < nrows ? rp[i] : 0;
+                    index_type last = 0;
+                    for (size_t j = 0; j < width; ++j) {
+                        const size_t pos = chunkPtr[k] + j * C + r;
+                        if (j < len) {
+                            last = ci[start + j];
+                            vals[pos] = va[start + j];
+                        }
+                        else {
+                            vals[pos] = T();
+                        }
+                        colIdx[pos] = last;
+                    }
+                }
+            }
+        });
+    }
+
+    size_t rows() const noexcept { return nrows; }
+    size_t cols() const noexcept { return ncols; }
+    size_t nnz() const noexcept { return count; }
+    size_t sigma() const noexcept { return window; }
+    static constexpr size_t chunk_height() noexcept { return C; }
+
+    //     
+    size_t stored() const noexcept { return vals.size(); }
+
+    TSparseMatrixCSR<T> to_csr() const
+    {
+        vector<size_t> rp(nrows + 1, 0);
+        for (size_t s = 0; s < perm.size(); ++s)
+            if (perm[s] < nrows)
+                rp[perm[s] + 1] = rowLen[s];
+        std::partial_sum(rp.begin(), rp.end(), rp.begin());
+        vector<index_type> ci(count);
+        vector<T> va(count);
+        for (size_t s = 0; s < perm.size(); ++s) {
+            if (perm[s] >= nrows)
+                continue;
+            const size_t k = s / C, r = s % C;
+            for (size_t j = 0; j < rowLen[s]; ++j) {
+                ci[rp[perm[s]] + j] = colIdx[chunkPtr[k] + j * C + r];
+                va[rp[perm[s]] + j] = vals[chunkPtr[k] + j * C + r];
+            }
+        }
+        return TSparseMatrixCSR<T>(nrows, ncols, std::move(rp), std::move(ci), std::move(va));
+    }
+
+    // y = A x;        
+    void multiply(const TDynamicVector<T>& x, TDynamicVector<T>& y) const
+    {
+        if (x.size() != ncols || y.size() != nrows)
+            throw invalid_argument("Vector sizes must match matrix for multiplication");
+        if (&x == &y)
+            throw invalid_argument("Output vector must not alias the input");
+
+        auto chunks_range = [&](size_t begin, size_t end) {
+            TSellKernels<T, C>::run(vals.data(), colIdx.data(), chunkPtr.data(), perm.data(), rowLen.data(),
+                                    begin, end, x.data(), y.data(), nrows);
+        };
+        const size_t parts = csr_parts(stored());
+        if (parts == 1) {
+            chunks_range(0, chunks());
+            return;
+        }
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            chunks_range(csr_bound(chunkPtr, parts, t), csr_bound(chunkPtr, parts, t + 1));
+        });
+    }
+
+    TDynamicVector<T> operator*(const TDynamicVector<T>& x) const
+    {
+        TDynamicVector<T> y(nrows);
+        multiply(x, y);
+        return y;
+    }
+};
+
+#endif
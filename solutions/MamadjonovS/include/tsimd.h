@@ -0,0 +1,454 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//      
+
+#ifndef __TSimd_H__
+#define __TSimd_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "tcpu.h"
+
+using namespace std;
+
+//   -
+//      T
+template<typename T>
+struct TScalarKernels
+{
+    static void add(const T* a, const T* b, T* r, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            r[i] = a[i] + b[i];
+    }
+
+    static void sub(const T* a, const T* b, T* r, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            r[i] = a[i] - b[i];
+    }
+
+    static void mul(const T* a, const T* b, T* r, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            r[i] = a[i] * b[i];
+    }
+
+    static void add_scalar(const T* a, T val, T* r, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            r[i] = a[i] + val;
+    }
+
+    static void sub_scalar(const T* a, T val, T* r, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            r[i] = a[i] - val;
+    }
+
+    static void mul_scalar(const T* a, T val, T* r, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            r[i] = a[i] * val;
+    }
+
+    // r[i] += val * x[i]
+    static void axpy(T val, const T* x, T* r, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            r[i] += val * x[i];
+    }
+
+    static T dot(const T* a, const T* b, size_t n)
+    {
+        T result = T();
+        for (size_t i = 0; i < n; ++i)
+            result += a[i] * b[i];
+        return result;
+    }
+};
+
+#ifdef TMATRIX_X86
+//   -
+//        ,
+//      .    :
+//      AVX    
+//      ,   __m256/__m512 
+//      ABI. gather  base[idx[l]] 
+//   l, gather_live -     len[l] > j, 
+//      ;     int32
+struct TAvx2Double
+{
+    using elem = double;
+    using vec = __m256d;
+    static constexpr size_t W = 4;
+    TMATRIX_TARGET_AVX2 static void zero(vec& r) { r = _mm256_setzero_pd(); }
+    TMATRIX_TARGET_AVX2 static void load(vec& r, const elem* p) { r = _mm256_loadu_pd(p); }
+    TMATRIX_TARGET_AVX2 static void store(elem* p, const vec& v) { _mm256_storeu_pd(p, v); }
+    TMATRIX_TARGET_AVX2 static void store_aligned(elem* p, const vec& v) { _mm256_store_pd(p, v); }
+    TMATRIX_TARGET_AVX2 static void set1(vec& r, elem x) { r = _mm256_set1_pd(x); }
+    TMATRIX_TARGET_AVX2 static void add(vec& r, const vec& a, const vec& b) { r = _mm256_add_pd(a, b); }
+    TMATRIX_TARGET_AVX2 static void sub(vec& r, const vec& a, const vec& b) { r = _mm256_sub_pd(a, b); }
+    TMATRIX_TARGET_AVX2 static void mul(vec& r, const vec& a, const vec& b) { r = _mm256_mul_pd(a, b); }
+    TMATRIX_TARGET_AVX2 static void fmadd(vec& acc, const vec& a, const vec& b) { acc = _mm256_fmadd_pd(a, b, acc); }
+    TMATRIX_TARGET_AVX2 static void gather(vec& r, const elem* base, const uint32_t* idx) { r = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx)), _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8); }
+    TMATRIX_TARGET_AVX2 static void gather_live(vec& r, const elem* base, const uint32_t* idx, const uint32_t* len, uint32_t j) { r = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx)), _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(len)), _mm_set1_epi32(int(j))))), 8); }
+};
+
+struct TAvx2Float
+{
+    using elem = float;
+    using vec = __m256;
+    static constexpr size_t W = 8;
+    TMATRIX_TARGET_AVX2 static void zero(vec& r) { r = _mm256_setzero_ps(); }
+    TMATRIX_TARGET_AVX2 static void load(vec& r, const elem* p) { r = _mm256_loadu_ps(p); }
+    TMATRIX_TARGET_AVX2 static void store(elem* p, const vec& v) { _mm256_storeu_ps(p, v); }
+    TMATRIX_TARGET_AVX2 static void store_aligned(elem* p, const vec& v) { _mm256_store_ps(p, v); }
+    TMATRIX_TARGET_AVX2 static void set1(vec& r, elem x) { r = _mm256_set1_ps(x); }
+    TMATRIX_TARGET_AVX2 static void add(vec& r, const vec& a, const vec& b) { r = _mm256_add_ps(a, b); }
+    TMATRIX_TARGET_AVX2 static void sub(vec& r, const vec& a, const vec& b) { r = _mm256_sub_ps(a, b); }
+    TMATRIX_TARGET_AVX2 static void mul(vec& r, const vec& a, const vec& b) { r = _mm256_mul_ps(a, b); }
+    TMATRIX_TARGET_AVX2 static void fmadd(vec& acc, const vec& a, const vec& b) { acc = _mm256_fmadd_ps(a, b, acc); }
+    TMATRIX_TARGET_AVX2 static void gather(vec& r, const elem* base, const uint32_t* idx) { r = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4); }
+    TMATRIX_TARGET_AVX2 static void gather_live(vec& r, const elem* base, const uint32_t* idx, const uint32_t* len, uint32_t j) { r = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(len)), _mm256_set1_epi32(int(j)))), 4); }
+};
+
+struct TAvx2Int
+{
+    using elem = int;
+    using vec = __m256i;
+    static constexpr size_t W = 8;
+    TMATRIX_TARGET_AVX2 static void zero(vec& r) { r = _mm256_setzero_si256(); }
+    TMATRIX_TARGET_AVX2 static void load(vec& r, const elem* p) { r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    TMATRIX_TARGET_AVX2 static void store(elem* p, const vec& v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    TMATRIX_TARGET_AVX2 static void store_aligned(elem* p, const vec& v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    TMATRIX_TARGET_AVX2 static void set1(vec& r, elem x) { r = _mm256_set1_epi32(x); }
+    TMATRIX_TARGET_AVX2 static void add(vec& r, const vec& a, const vec& b) { r = _mm256_add_epi32(a, b); }
+    TMATRIX_TARGET_AVX2 static void sub(vec& r, const vec& a, const vec& b) { r = _mm256_sub_epi32(a, b); }
+    TMATRIX_TARGET_AVX2 static void mul(vec& r, const vec& a, const vec& b) { r = _mm256_mullo_epi32(a, b); }
+    TMATRIX_TARGET_AVX2 static void fmadd(vec& acc, const vec& a, const vec& b) { acc = _mm256_add_epi32(_mm256_mullo_epi32(a, b), acc); }
+    TMATRIX_TARGET_AVX2 static void gather(vec& r, const elem* base, const uint32_t* idx) { r = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), _mm256_set1_epi32(-1), 4); }
+    TMATRIX_TARGET_AVX2 static void gather_live(vec& r, const elem* base, const uint32_t* idx, const uint32_t* len, uint32_t j) { r = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(len)), _mm256_set1_epi32(int(j))), 4); }
+};
+
+struct TAvx512Double
+{
+    using elem = double;
+    using vec = __m512d;
+    static constexpr size_t W = 8;
+    TMATRIX_TARGET_AVX512 static void zero(vec& r) { r = _mm512_setzero_pd(); }
+    TMATRIX_TARGET_AVX512 static void load(vec& r, const elem* p) { r = _mm512_loadu_pd(p); }
+    TMATRIX_TARGET_AVX512 static void store(elem* p, const vec& v) { _mm512_storeu_pd(p, v); }
+    TMATRIX_TARGET_AVX512 static void store_aligned(elem* p, const vec& v) { _mm512_store_pd(p, v); }
+    TMATRIX_TARGET_AVX512 static void set1(vec& r, elem x) { r = _mm512_set1_pd(x); }
+    TMATRIX_TARGET_AVX512 static void add(vec& r, const vec& a, const vec& b) { r = _mm512_add_pd(a, b); }
+    TMATRIX_TARGET_AVX512 static void sub(vec& r, const vec& a, const vec& b) { r = _mm512_sub_pd(a, b); }
+    TMATRIX_TARGET_AVX512 static void mul(vec& r, const vec& a, const vec& b) { r = _mm512_mul_pd(a, b); }
+    TMATRIX_TARGET_AVX512 static void fmadd(vec& acc, const vec& a, const vec& b) { acc = _mm512_fmadd_pd(a, b, acc); }
+    TMATRIX_TARGET_AVX512 static void gather(vec& r, const elem* base, const uint32_t* idx) { r = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), __mmask8(0xFF), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), base, 8); }
+    TMATRIX_TARGET_AVX512 static void gather_live(vec& r, const elem* base, const uint32_t* idx, const uint32_t* len, uint32_t j) { r = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), __mmask8(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(len)), _mm256_set1_epi32(int(j)))))), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), base, 8); }
+};
+
+struct TAvx512Float
+{
+    using elem = float;
+    using vec = __m512;
+    static constexpr size_t W = 16;
+    TMATRIX_TARGET_AVX512 static void zero(vec& r) { r = _mm512_setzero_ps(); }
+    TMATRIX_TARGET_AVX512 static void load(vec& r, const elem* p) { r = _mm512_loadu_ps(p); }
+    TMATRIX_TARGET_AVX512 static void store(elem* p, const vec& v) { _mm512_storeu_ps(p, v); }
+    TMATRIX_TARGET_AVX512 static void store_aligned(elem* p, const vec& v) { _mm512_store_ps(p, v); }
+    TMATRIX_TARGET_AVX512 static void set1(vec& r, elem x) { r = _mm512_set1_ps(x); }
+    TMATRIX_TARGET_AVX512 static void add(vec& r, const vec& a, const vec& b) { r = _mm512_add_ps(a, b); }
+    TMATRIX_TARGET_AVX512 static void sub(vec& r, const vec& a, const vec& b) { r = _mm512_sub_ps(a, b); }
+    TMATRIX_TARGET_AVX512 static void mul(vec& r, const vec& a, const vec& b) { r = _mm512_mul_ps(a, b); }
+    TMATRIX_TARGET_AVX512 static void fmadd(vec& acc, const vec& a, const vec& b) { acc = _mm512_fmadd_ps(a, b, acc); }
+    TMATRIX_TARGET_AVX512 static void gather(vec& r, const elem* base, const uint32_t* idx) { r = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), __mmask16(0xFFFF), _mm512_loadu_si512(idx), base, 4); }
+    TMATRIX_TARGET_AVX512 static void gather_live(vec& r, const elem* base, const uint32_t* idx, const uint32_t* len, uint32_t j) { r = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), _mm512_cmpgt_epi32_mask(_mm512_loadu_si512(len), _mm512_set1_epi32(int(j))), _mm512_loadu_si512(idx), base, 4); }
+};
+
+struct TAvx512Int
+{
+    using elem = int;
+    using vec = __m512i;
+    static constexpr size_t W = 16;
+    TMATRIX_TARGET_AVX512 static void zero(vec& r) { r = _mm512_setzero_si512(); }
+    TMATRIX_TARGET_AVX512 static void load(vec& r, const elem* p) { r = _mm512_loadu_si512(p); }
+    TMATRIX_TARGET_AVX512 static void store(elem* p, const vec& v) { _mm512_storeu_si512(p, v); }
+    TMATRIX_TARGET_AVX512 static void store_aligned(elem* p, const vec& v) { _mm512_store_si512(p, v); }
+    TMATRIX_TARGET_AVX512 static void set1(vec& r, elem x) { r = _mm512_set1_epi32(x); }
+    TMATRIX_TARGET_AVX512 static void add(vec& r, const vec& a, const vec& b) { r = _mm512_add_epi32(a, b); }
+    TMATRIX_TARGET_AVX512 static void sub(vec& r, const vec& a, const vec& b) { r = _mm512_sub_epi32(a, b); }
+    TMATRIX_TARGET_AVX512 static void mul(vec& r, const vec& a, const vec& b) { r = _mm512_mullo_epi32(a, b); }
+    TMATRIX_TARGET_AVX512 static void fmadd(vec& acc, const vec& a, const vec& b) { acc = _mm512_add_epi32(_mm512_mullo_epi32(a, b), acc); }
+    TMATRIX_TARGET_AVX512 static void gather(vec& r, const elem* base, const uint32_t* idx) { r = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), __mmask16(0xFFFF), _mm512_loadu_si512(idx), base, 4); }
+    TMATRIX_TARGET_AVX512 static void gather_live(vec& r, const elem* base, const uint32_t* idx, const uint32_t* len, uint32_t j) { r = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), _mm512_cmpgt_epi32_mask(_mm512_loadu_si512(len), _mm512_set1_epi32(int(j))), _mm512_loadu_si512(idx), base, 4); }
+};
+
+//   -
+//  Op::run        
+#define TMATRIX_FLATTEN __attribute__((flatten))
+
+template<typename Op, typename... Args>
+TMATRIX_TARGET_AVX2 TMATRIX_FLATTEN auto simd_run_avx2(Args... args)
+{
+    return Op::run(args...);
+}
+
+template<typename Op, typename... Args>
+TMATRIX_TARGET_AVX512 TMATRIX_FLATTEN auto simd_run_avx512(Args... args)
+{
+    return Op::run(args...);
+}
+
+//   -
+//    :    
+//  ,   ,   ;
+//    
+template<typename V>
+struct TSimdKernels
+{
+    using T = typename V::elem;
+    using vec = typename V::vec;
+    static constexpr size_t W = V::W;
+
+    static size_t head(const T* r, size_t n) noexcept
+    {
+        const size_t offset = (reinterpret_cast<uintptr_t>(r) / sizeof(T)) % W;
+        return std::min(n, offset == 0 ? 0 : W - offset);
+    }
+
+    struct OpAdd
+    {
+        static T apply(T a, T b) { return a + b; }
+        static void apply(vec& r, const vec& a, const vec& b) { V::add(r, a, b); }
+    };
+
+    struct OpSub
+    {
+        static T apply(T a, T b) { return a - b; }
+        static void apply(vec& r, const vec& a, const vec& b) { V::sub(r, a, b); }
+    };
+
+    struct OpMul
+    {
+        static T apply(T a, T b) { return a * b; }
+        static void apply(vec& r, const vec& a, const vec& b) { V::mul(r, a, b); }
+    };
+
+    // r[i] = a[i] op b[i]
+    template<typename Op>
+    struct Binary
+    {
+        static void step(const T* a, const T* b, T* r)
+        {
+            vec x, y;
+            V::load(x, a);
+            V::load(y, b);
+            Op::apply(x, x, y);
+            V::store_aligned(r, x);
+        }
+
+        static void run(const T* a, const T* b, T* r, size_t n)
+        {
+            size_t i = 0;
+            for (const size_t h = head(r, n); i < h; ++i)
+                r[i] = Op::apply(a[i], b[i]);
+            for (; i + 2 * W <= n; i += 2 * W) {
+                step(a + i, b + i, r + i);
+                step(a + i + W, b + i + W, r + i + W);
+            }
+            for (; i + W <= n; i += W)
+                step(a + i, b + i, r + i);
+            for (; i < n; ++i)
+                r[i] = Op::apply(a[i], b[i]);
+        }
+    };
+
+    // r[i] = a[i] op val
+    template<typename Op>
+    struct Scalar
+    {
+        static void step(const T* a, const vec& v, T* r)
+        {
+            vec x;
+            V::load(x, a);
+            Op::apply(x, x, v);
+            V::store_aligned(r, x);
+        }
+
+        static void run(const T* a, T val, T* r, size_t n)
+        {
+            size_t i = 0;
+            for (const size_t h = head(r, n); i < h; ++i)
+                r[i] = Op::apply(a[i], val);
+            vec v;
+            V::set1(v, val);
+            for (; i + 2 * W <= n; i += 2 * W) {
+                step(a + i, v, r + i);
+                step(a + i + W, v, r + i + W);
+            }
+            for (; i + W <= n; i += W)
+                step(a + i, v, r + i);
+            for (; i < n; ++i)
+                r[i] = Op::apply(a[i], val);
+        }
+    };
+
+    // r[i] += val * x[i]
+    struct Axpy
+    {
+        static void step(const vec& v, const T* x, T* r)
+        {
+            vec a, y;
+            V::load(a, x);
+            V::load(y, r);
+            V::fmadd(y, v, a);
+            V::store_aligned(r, y);
+        }
+
+        static void run(T val, const T* x, T* r, size_t n)
+        {
+            size_t i = 0;
+            for (const size_t h = head(r, n); i < h; ++i)
+                r[i] += val * x[i];
+            vec v;
+            V::set1(v, val);
+            for (; i + 2 * W <= n; i += 2 * W) {
+                step(v, x + i, r + i);
+                step(v, x + i + W, r + i + W);
+            }
+            for (; i + W <= n; i += W)
+                step(v, x + i, r + i);
+            for (; i < n; ++i)
+                r[i] += val * x[i];
+        }
+    };
+
+    //      FMA,
+    //        
+    struct Dot
+    {
+        static void step(vec& acc, const T* a, const T* b)
+        {
+            vec x, y;
+            V::load(x, a);
+            V::load(y, b);
+            V::fmadd(acc, x, y);
+        }
+
+        static T run(const T* a, const T* b, size_t n)
+        {
+            vec acc0, acc1, acc2, acc3;
+            V::zero(acc0);
+            V::zero(acc1);
+            V::zero(acc2);
+            V::zero(acc3);
+            size_t i = 0;
+            for (; i + 4 * W <= n; i += 4 * W) {
+                step(acc0, a + i, b + i);
+                step(acc1, a + i + W, b + i + W);
+                step(acc2, a + i + 2 * W, b + i + 2 * W);
+                step(acc3, a + i + 3 * W, b + i + 3 * W);
+            }
+            for (; i + W <= n; i += W)
+                step(acc0, a + i, b + i);
+            V::add(acc0, acc0, acc1);
+            V::add(acc2, acc2, acc3);
+            V::add(acc0, acc0, acc2);
+
+            T lanes[W];
+            V::store(lanes, acc0);
+            T result = T();
+            for (size_t j = 0; j < W; ++j)
+                result += lanes[j];
+            for (; i < n; ++i)
+                result += a[i] * b[i];
+            return result;
+        }
+    };
+};
+
+template<typename K> using TSimdAdd = typename K::template Binary<typename K::OpAdd>;
+template<typename K> using TSimdSub = typename K::template Binary<typename K::OpSub>;
+template<typename K> using TSimdMul = typename K::template Binary<typename K::OpMul>;
+template<typename K> using TSimdAddScalar = typename K::template Scalar<typename K::OpAdd>;
+template<typename K> using TSimdSubScalar = typename K::template Scalar<typename K::OpSub>;
+template<typename K> using TSimdMulScalar = typename K::template Scalar<typename K::OpMul>;
+template<typename K> using TSimdAxpy = typename K::Axpy;
+template<typename K> using TSimdDot = typename K::Dot;
+
+//   -
+//  double, float  int     TCpu::level()
+template<typename V2, typename V512>
+struct TVectorKernelsX86
+{
+    using T = typename V2::elem;
+    using TPortable = TScalarKernels<T>;
+
+    template<template<typename> class Op, typename Fallback, typename... Args>
+    static auto dispatch(Fallback fallback, Args... args)
+    {
+        switch (TCpu::level()) {
+        case TCpuLevel::AVX512: return simd_run_avx512<Op<TSimdKernels<V512>>>(args...);
+        case TCpuLevel::AVX2: return simd_run_avx2<Op<TSimdKernels<V2>>>(args...);
+        default: return fallback(args...);
+        }
+    }
+
+    static void add(const T* a, const T* b, T* r, size_t n)
+    {
+        dispatch<TSimdAdd>(&TPortable::add, a, b, r, n);
+    }
+
+    static void sub(const T* a, const T* b, T* r, size_t n)
+    {
+        dispatch<TSimdSub>(&TPortable::sub, a, b, r, n);
+    }
+
+    static void mul(const T* a, const T* b, T* r, size_t n)
+    {
+        dispatch<TSimdMul>(&TPortable::mul, a, b, r, n);
+    }
+
+    static void add_scalar(const T* a, T val, T* r, size_t n)
+    {
+        dispatch<TSimdAddScalar>(&TPortable::add_scalar, a, val, r, n);
+    }
+
+    static void sub_scalar(const T* a, T val, T* r, size_t n)
+    {
+        dispatch<TSimdSubScalar>(&TPortable::sub_scalar, a, val, r, n);
+    }
+
+    static void mul_scalar(const T* a, T val, T* r, size_t n)
+    {
+        dispatch<TSimdMulScalar>(&TPortable::mul_scalar, a, val, r, n);
+    }
+
+    static void axpy(T val, const T* x, T* r, size_t n)
+    {
+        dispatch<TSimdAxpy>(&TPortable::axpy, val, x, r, n);
+    }
+
+    static T dot(const T* a, const T* b, size_t n)
+    {
+        return dispatch<TSimdDot>(&TPortable::dot, a, b, n);
+    }
+};
+#endif
+
+template<typename T>
+struct TVectorKernels : TScalarKernels<T> {};
+
+#ifdef TMATRIX_X86
+template<> struct TVectorKernels<double> : TVectorKernelsX86<TAvx2Double, TAvx512Double> {};
+template<> struct TVectorKernels<float> : TVectorKernelsX86<TAvx2Float, TAvx512Float> {};
+template<> struct TVectorKernels<int> : TVectorKernelsX86<TAvx2Int, TAvx512Int> {};
+#endif
+
+#endif
@@ -0,0 +1,546 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//     CSR  CSC
+
+#ifndef __TSparse_H__
+#define __TSparse_H__
+
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "tmatrix.h"
+
+using namespace std;
+
+//          SPARSE_GRAIN 
+constexpr size_t SPARSE_GRAIN = EXPR_GRAIN;
+
+//    parts      :
+//   t -  ,    t / parts 
+// .     t,     
+//   ,    ( SpMV   )
+inline size_t csr_bound(const vector<size_t>& row_ptr, size_t parts, size_t t)
+{
+    const size_t rows = row_ptr.size() - 1;
+    if (t == 0)
+        return 0;
+    if (t >= parts)
+        return rows;
+    const size_t nnz = row_ptr.back();
+    const size_t target = nnz / parts * t + nnz % parts * t / parts;
+    return std::min(size_t(std::lower_bound(row_ptr.begin(), row_ptr.end(), target) - row_ptr.begin()), rows);
+}
+
+//  parts + 1  
+inline vector<size_t> csr_partition(const vector<size_t>& row_ptr, size_t parts)
+{
+    vector<size_t> bounds(parts + 1);
+    for (size_t t = 0; t <= parts; ++t)
+        bounds[t] = csr_bound(row_ptr, parts, t);
+    return bounds;
+}
+
+//     nnz   
+inline size_t csr_parts(size_t nnz)
+{
+    return std::max<size_t>(1, std::min(TThreadPool::threads(), nnz / SPARSE_GRAIN));
+}
+
+//   SpMM -
+// X - xrows   k    ldx, Y - yrows    ldy.
+//    k,    X  Y  
+template<typename T>
+void spmm_check_blocks(const T* x, size_t xrows, size_t ldx, const T* y, size_t yrows, size_t ldy, size_t k)
+{
+    if (x == nullptr || y == nullptr)
+        throw invalid_argument("SpMM blocks must not be null");
+    if (ldx < k || ldy < k)
+        throw invalid_argument("Block row stride must be at least the number of vectors");
+    const T* xend = x + (xrows - 1) * ldx + k;
+    const T* yend = y + (yrows - 1) * ldy + k;
+    if (std::less<const T*>()(x, yend) && std::less<const T*>()(y, xend))
+        throw invalid_argument("Output block must not overlap the input");
+}
+
+//  SpMM   [begin, end) -
+// Y[i] =  A[i][c] * X[c]    k , X  Y  
+//   ldx  ldy:    , 
+//  A   k   X
+template<typename T>
+void spmm_kernel_ref(const size_t* row_ptr, const uint32_t* cols, const T* vals, size_t begin, size_t end,
+                     const T* x, size_t ldx, T* y, size_t ldy, size_t k)
+{
+    for (size_t i = begin; i < end; ++i) {
+        T* yi = y + i * ldy;
+        std::fill(yi, yi + k, T());
+        for (size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+            const T a = vals[p];
+            const T* xr = x + size_t(cols[p]) * ldx;
+            for (size_t j = 0; j < k; ++j)
+                yi[j] += a * xr[j];
+        }
+    }
+}
+
+#ifdef TMATRIX_X86
+//   SpMM -
+//  Y    4 :     
+//       .     A
+//          L1
+template<typename V>
+struct TSpmmKernel
+{
+    using T = typename V::elem;
+    using vec = typename V::vec;
+    static constexpr size_t W = V::W;
+
+    template<size_t NV>
+    static void strip(const size_t* row_ptr, const uint32_t* cols, const T* vals,
+                      size_t i, const T* x, size_t ldx, T* yi, size_t j)
+    {
+        vec acc[NV];
+#pragma GCC unroll 4
+        for (size_t q = 0; q < NV; ++q)
+            V::zero(acc[q]);
+        for (size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+            vec a;
+            V::set1(a, vals[p]);
+            const T* xr = x + size_t(cols[p]) * ldx + j;
+#pragma GCC unroll 4
+            for (size_t q = 0; q < NV; ++q) {
+                vec b;
+                V::load(b, xr + q * W);
+                V::fmadd(acc[q], a, b);
+            }
+        }
+#pragma GCC unroll 4
+        for (size_t q = 0; q < NV; ++q)
+            V::store(yi + j + q * W, acc[q]);
+    }
+
+    static void run(const size_t* row_ptr, const uint32_t* cols, const T* vals, size_t begin, size_t end,
+                    const T* x, size_t ldx, T* y, size_t ldy, size_t k)
+    {
+        for (size_t i = begin; i < end; ++i) {
+            T* yi = y + i * ldy;
+            size_t j = 0;
+            for (; j + 4 * W <= k; j += 4 * W)
+                strip<4>(row_ptr, cols, vals, i, x, ldx, yi, j);
+            for (; j + W <= k; j += W)
+                strip<1>(row_ptr, cols, vals, i, x, ldx, yi, j);
+            if (j < k) {
+                std::fill(yi + j, yi + k, T());
+                for (size_t p = row_ptr[i]; p < row_ptr[i + 1]; ++p) {
+                    const T a = vals[p];
+                    const T* xr = x + size_t(cols[p]) * ldx;
+                    for (size_t jj = j; jj < k; ++jj)
+                        yi[jj] += a * xr[jj];
+                }
+            }
+        }
+    }
+};
+#endif
+
+template<typename T>
+struct TSpmmKernels
+{
+    static void run(const size_t* row_ptr, const uint32_t* cols, const T* vals, size_t begin, size_t end,
+                    const T* x, size_t ldx, T* y, size_t ldy, size_t k)
+    {
+        spmm_kernel_ref(row_ptr, cols, vals, begin, end, x, ldx, y, ldy, k);
+    }
+};
+
+#ifdef TMATRIX_X86
+template<typename V2, typename V512>
+struct TSpmmKernelsX86
+{
+    using T = typename V2::elem;
+
+    static void run(const size_t* row_ptr, const uint32_t* cols, const T* vals, size_t begin, size_t end,
+                    const T* x, size_t ldx, T* y, size_t ldy, size_t k)
+    {
+        switch (TCpu::level()) {
+        case TCpuLevel::AVX512: return simd_run_avx512<TSpmmKernel<V512>>(row_ptr, cols, vals, begin, end, x, ldx, y, ldy, k);
+        case TCpuLevel::AVX2: return simd_run_avx2<TSpmmKernel<V2>>(row_ptr, cols, vals, begin, end, x, ldx, y, ldy, k);
+        default: return spmm_kernel_ref(row_ptr, cols, vals, begin, end, x, ldx, y, ldy, k);
+        }
+    }
+};
+
+template<> struct TSpmmKernels<double> : TSpmmKernelsX86<TAvx2Double, TAvx512Double> {};
+template<> struct TSpmmKernels<float> : TSpmmKernelsX86<TAvx2Float, TAvx512Float> {};
+template<> struct TSpmmKernels<int> : TSpmmKernelsX86<TAvx2Int, TAvx512Int> {};
+#endif
+
+template<typename T>
+class TSparseBuilder;
+
+template<typename T>
+struct TSpGemm;
+
+//   -
+//   :   i  
+// [row_ptr[i], row_ptr[i + 1])  col_idx  values,
+//        
+template<typename T>
+class TSparseMatrixCSR
+{
+public:
+    using index_type = uint32_t;
+    using value_type = T;
+
+private:
+    size_t nrows, ncols;
+    vector<size_t> rowPtr;
+    vector<index_type> colIdx;
+    vector<T> vals;
+
+    friend class TSparseBuilder<T>;
+    friend struct TSpGemm<T>;
+
+    static void check_size(size_t rows, size_t cols)
+    {
+        if (rows == 0 || cols == 0)
+            throw out_of_range("Matrix size should be greater than zero");
+        if (rows > MAX_VECTOR_SIZE || cols > MAX_VECTOR_SIZE)
+            throw out_of_range("Matrix size exceeds maximum allowed");
+    }
+
+    //        :
+    //      ,   
+    template<typename Op>
+    static TSparseMatrixCSR merge(const TSparseMatrixCSR& a, const TSparseMatrixCSR& b, Op op)
+    {
+        if (a.nrows != b.nrows || a.ncols != b.ncols)
+            throw invalid_argument("Matrix sizes must be equal for element-wise operations");
+
+        TSparseMatrixCSR r(a.nrows, a.ncols);
+        const size_t grain = std::max<size_t>(1, SPARSE_GRAIN / std::max<size_t>(1, (a.nnz() + b.nnz()) / a.nrows));
+        TThreadPool::parallel_blocks(a.nrows, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                r.rowPtr[i + 1] = merge_row(a, b, i, op, nullptr, nullptr);
+        });
+        std::partial_sum(r.rowPtr.begin(), r.rowPtr.end(), r.rowPtr.begin());
+        r.colIdx.resize(r.rowPtr.back());
+        r.vals.resize(r.rowPtr.back());
+        TThreadPool::parallel_blocks(a.nrows, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                merge_row(a, b, i, op, r.colIdx.data() + r.rowPtr[i], r.vals.data() + r.rowPtr[i]);
+        });
+        return r;
+    }
+
+    //      
+    template<typename Op>
+    static size_t merge_row(const TSparseMatrixCSR& a, const TSparseMatrixCSR& b, size_t i, Op op,
+                            index_type* cols, T* out)
+    {
+        size_t p = a.rowPtr[i], q = b.rowPtr[i], n = 0;
+        const size_t pe = a.rowPtr[i + 1], qe = b.rowPtr[i + 1];
+        while (p < pe || q < qe) {
+            index_type c;
+            T v;
+            if (q == qe || (p < pe && a.colIdx[p] < b.colIdx[q])) {
+                c = a.colIdx[p];
+                v = op(a.vals[p++], T());
+            }
+            else if (p == pe || b.colIdx[q] < a.colIdx[p]) {
+                c = b.colIdx[q];
+                v = op(T(), b.vals[q++]);
+            }
+            else {
+                c = a.colIdx[p];
+                v = op(a.vals[p++], b.vals[q++]);
+            }
+            if (cols != nullptr) {
+                cols[n] = c;
+                out[n] = v;
+            }
+            ++n;
+        }
+        return n;
+    }
+
+public:
+    TSparseMatrixCSR(size_t rows = 1, size_t cols = 1) : nrows(rows), ncols(cols), rowPtr(rows + 1, 0)
+    {
+        check_size(rows, cols);
+    }
+
+    //   CSR;  
+    TSparseMatrixCSR(size_t rows, size_t cols, vector<size_t> row_ptr,
+                     vector<index_type> col_idx, vector<T> values)
+        : nrows(rows), ncols(cols), rowPtr(std::move(row_ptr)), colIdx(std::move(col_idx)), vals(std::move(values))
+    {
+        check_size(rows, cols);
+        if (rowPtr.size() != rows + 1 || rowPtr[0] != 0 || rowPtr.back() != colIdx.size() || colIdx.size() != vals.size())
+            throw invalid_argument("Inconsistent CSR arrays");
+        for (size_t i = 0; i < rows; ++i) {
+            if (rowPtr[i] > rowPtr[i + 1])
+                throw invalid_argument("CSR row pointers must not decrease");
+            for (size_t k = rowPtr[i]; k < rowPtr[i + 1]; ++k) {
+                if (colIdx[k] >= cols)
+                    throw out_of_range("CSR column index out of range");
+                if (k > rowPtr[i] && colIdx[k] <= colIdx[k - 1])
+                    throw invalid_argument("CSR columns must be strictly increasing within a row");
+            }
+        }
+    }
+
+    //    
+    explicit TSparseMatrixCSR(const TDynamicMatrix<T>& m) : TSparseMatrixCSR(m.size(), m.size())
+    {
+        for (size_t i = 0; i < nrows; ++i) {
+            const T* r = m[i].data();
+            for (size_t j = 0; j < ncols; ++j) {
+                if (r[j] != T()) {
+                    colIdx.push_back(index_type(j));
+                    vals.push_back(r[j]);
+                }
+            }
+            rowPtr[i + 1] = colIdx.size();
+        }
+    }
+
+    size_t rows() const noexcept { return nrows; }
+    size_t cols() const noexcept { return ncols; }
+    size_t nnz() const noexcept { return vals.size(); }
+
+    const vector<size_t>& row_ptr() const noexcept { return rowPtr; }
+    const vector<index_type>& col_idx() const noexcept { return colIdx; }
+    const vector<T>& values() const noexcept { return vals; }
+
+    //       (,  
+    // );    
+    void set_values(vector<T> values)
+    {
+        if (values.size() != vals.size())
+            throw invalid_argument("Value count must equal the number of stored elements");
+        vals = std::move(values);
+    }
+
+    //  (i, j)  ;    
+    T get(size_t i, size_t j) const
+    {
+        if (i >= nrows || j >= ncols)
+            throw out_of_range("Index out of range in get()");
+        const auto first = colIdx.begin() + rowPtr[i], last = colIdx.begin() + rowPtr[i + 1];
+        const auto it = std::lower_bound(first, last, index_type(j));
+        return it != last && *it == j ? vals[it - colIdx.begin()] : T();
+    }
+
+    bool operator==(const TSparseMatrixCSR& m) const
+    {
+        return nrows == m.nrows && ncols == m.ncols && rowPtr == m.rowPtr && colIdx == m.colIdx && vals == m.vals;
+    }
+
+    bool operator!=(const TSparseMatrixCSR& m) const
+    {
+        return !(*this == m);
+    }
+
+    // y = A x   ;      
+    //  ,   ,      
+    void multiply(const TDynamicVector<T>& x, TDynamicVector<T>& y) const
+    {
+        if (x.size() != ncols || y.size() != nrows)
+            throw invalid_argument("Vector sizes must match matrix for multiplication");
+        if (&x == &y)
+            throw invalid_argument("Output vector must not alias the input");
+
+        const T* px = x.data();
+        T* py = y.data();
+        const size_t parts = csr_parts(nnz());
+        auto rows_range = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                T sum = T();
+                for (size_t k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+                    sum += vals[k] * px[colIdx[k]];
+                py[i] = sum;
+            }
+        };
+        if (parts == 1) {
+            rows_range(0, nrows);
+            return;
+        }
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            rows_range(csr_bound(rowPtr, parts, t), csr_bound(rowPtr, parts, t + 1));
+        });
+    }
+
+    TDynamicVector<T> operator*(const TDynamicVector<T>& x) const
+    {
+        TDynamicVector<T> y(nrows);
+        multiply(x, y);
+        return y;
+    }
+
+    // Y = A X  k  : X (cols x k)  Y (rows x k) 
+    //     ldx  ldy.      
+    // ,   k ,   k  SpMV
+    void multiply(const T* x, size_t ldx, T* y, size_t ldy, size_t k) const
+    {
+        if (k == 0)
+            return;
+        spmm_check_blocks(x, ncols, ldx, y, nrows, ldy, k);
+
+        auto rows_range = [&](size_t begin, size_t end) {
+            TSpmmKernels<T>::run(rowPtr.data(), colIdx.data(), vals.data(), begin, end, x, ldx, y, ldy, k);
+        };
+        const size_t parts = csr_parts(nnz() * k);
+        if (parts == 1) {
+            rows_range(0, nrows);
+            return;
+        }
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            rows_range(csr_bound(rowPtr, parts, t), csr_bound(rowPtr, parts, t + 1));
+        });
+    }
+
+    //  A   X:   x.size() 
+    void multiply(const TDynamicMatrix<T>& x, TDynamicMatrix<T>& y) const
+    {
+        if (nrows != ncols || x.size() != ncols || y.size() != nrows)
+            throw invalid_argument("Matrix sizes must match for multiplication");
+        multiply(x.data(), x.ld(), y.data(), y.ld(), x.size());
+    }
+
+    TDynamicMatrix<T> operator*(const TDynamicMatrix<T>& x) const
+    {
+        TDynamicMatrix<T> y(nrows);
+        multiply(x, y);
+        return y;
+    }
+
+    //   O(nnz + cols) -
+    //        ,   
+    //   ;    (, ) 
+    //        ,  
+    //         
+    TSparseMatrixCSR transpose() const
+    {
+        TSparseMatrixCSR r(ncols, nrows);
+        r.colIdx.resize(nnz());
+        r.vals.resize(nnz());
+        const size_t parts = csr_parts(nnz());
+        const vector<size_t> bounds = csr_partition(rowPtr, parts);
+        vector<size_t> hist(parts * ncols, 0);
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            size_t* h = hist.data() + t * ncols;
+            for (size_t p = rowPtr[bounds[t]]; p < rowPtr[bounds[t + 1]]; ++p)
+                ++h[colIdx[p]];
+        });
+        TThreadPool::parallel_blocks(ncols, SPARSE_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                size_t sum = 0;
+                for (size_t t = 0; t < parts; ++t) {
+                    const size_t count = hist[t * ncols + c];
+                    hist[t * ncols + c] = sum;
+                    sum += count;
+                }
+                r.rowPtr[c + 1] = sum;
+            }
+        });
+        std::partial_sum(r.rowPtr.begin(), r.rowPtr.end(), r.rowPtr.begin());
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            size_t* h = hist.data() + t * ncols;
+            for (size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+                for (size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+                    const size_t pos = r.rowPtr[colIdx[p]] + h[colIdx[p]]++;
+                    r.colIdx[pos] = index_type(i);
+                    r.vals[pos] = vals[p];
+                }
+        });
+        return r;
+    }
+
+    //     ;  
+    // ,     
+    TSparseMatrixCSR operator+(const TSparseMatrixCSR& m) const
+    {
+        return merge(*this, m, [](const T& a, const T& b) { return a + b; });
+    }
+
+    TSparseMatrixCSR operator-(const TSparseMatrixCSR& m) const
+    {
+        return merge(*this, m, [](const T& a, const T& b) { return a - b; });
+    }
+
+    TSparseMatrixCSR operator*(const T& val) const
+    {
+        TSparseMatrixCSR r(*this);
+        TVectorKernels<T>::mul_scalar(r.vals.data(), val, r.vals.data(), r.vals.size());
+        return r;
+    }
+
+    TDynamicMatrix<T> to_dense() const
+    {
+        if (nrows != ncols)
+            throw invalid_argument("Only square sparse matrices convert to TDynamicMatrix");
+
+        TDynamicMatrix<T> m(nrows);
+        for (size_t i = 0; i < nrows; ++i)
+            for (size_t k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+                m[i][colIdx[k]] = vals[k];
+        return m;
+    }
+
+    friend ostream& operator<<(ostream& ostr, const TSparseMatrixCSR& m)
+    {
+        ostr << "Sparse matrix " << m.nrows << "x" << m.ncols << ", nnz = " << m.nnz() << ":\n";
+        for (size_t i = 0; i < m.nrows; ++i)
+            for (size_t k = m.rowPtr[i]; k < m.rowPtr[i + 1]; ++k)
+                ostr << "  (" << i << ", " << m.colIdx[k] << ") " << m.vals[k] << "\n";
+        return ostr;
+    }
+};
+
+//     (CSC) -
+//  CSC  A    CSR  A^T, 
+//     CSR,    
+//  -   
+template<typename T>
+class TSparseMatrixCSC
+{
+public:
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+    using value_type = T;
+
+private:
+    TSparseMatrixCSR<T> t;
+
+public:
+    explicit TSparseMatrixCSC(const TSparseMatrixCSR<T>& a) : t(a.transpose()) {}
+
+    size_t rows() const noexcept { return t.cols(); }
+    size_t cols() const noexcept { return t.rows(); }
+    size_t nnz() const noexcept { return t.nnz(); }
+
+    //  j:  [col_ptr[j], col_ptr[j + 1])  row_idx  
+    const vector<size_t>& col_ptr() const noexcept { return t.row_ptr(); }
+    const vector<index_type>& row_idx() const noexcept { return t.col_idx(); }
+    const vector<T>& values() const noexcept { return t.values(); }
+
+    T get(size_t i, size_t j) const
+    {
+        if (i >= rows() || j >= cols())
+            throw out_of_range("Index out of range in get()");
+        return t.get(j, i);
+    }
+
+    TSparseMatrixCSR<T> to_csr() const
+    {
+        return t.transpose();
+    }
+
+    // A^T  CSR  
+    const TSparseMatrixCSR<T>& transposed() const noexcept { return t; }
+};
+
+#endif
@@ -0,0 +1,235 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//       (, , )
+
+#ifndef __TSparseBuilder_H__
+#define __TSparseBuilder_H__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "tsparse.h"
+
+using namespace std;
+
+//    -
+//        :  
+//   . build()  ,   
+//  row * cols + col  ,  
+//   CSR;           
+template<typename T>
+class TSparseBuilder
+{
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+
+    struct TEntry
+    {
+        uint64_t key;
+        T value;
+    };
+
+    struct TBuffer
+    {
+        thread::id owner;
+        vector<TEntry> entries;
+    };
+
+    size_t nrows, ncols;
+    uint64_t id;
+    mutex m;
+    vector<unique_ptr<TBuffer>> buffers;
+
+    static uint64_t next_id() noexcept
+    {
+        static atomic<uint64_t> counter(0);
+        return ++counter;
+    }
+
+    //   ;   
+    //   ,       
+    //     ,      
+    //    ,       
+    TBuffer& local()
+    {
+        struct TCache { uint64_t owner; TBuffer* buffer; };
+        static thread_local TCache cache = { 0, nullptr };
+        if (cache.owner != id) {
+            const thread::id self = this_thread::get_id();
+            lock_guard<mutex> lock(m);
+            TBuffer* found = nullptr;
+            for (const unique_ptr<TBuffer>& b : buffers)
+                if (b->owner == self) {
+                    found = b.get();
+                    break;
+                }
+            if (found == nullptr) {
+                buffers.push_back(unique_ptr<TBuffer>(new TBuffer));
+                found = buffers.back().get();
+                found->owner = self;
+            }
+            cache.owner = id;
+            cache.buffer = found;
+        }
+        return *cache.buffer;
+    }
+
+    //      bits  ,
+    //  8   ;     
+    static void radix_sort(vector<TEntry>& a, vector<TEntry>& tmp, unsigned bits)
+    {
+        const size_t n = a.size();
+        const size_t parts = csr_parts(n);
+        const size_t chunk = (n + parts - 1) / parts;
+        vector<size_t> hist(parts * 256);
+        for (unsigned shift = 0; shift < bits; shift += 8) {
+            std::fill(hist.begin(), hist.end(), 0);
+            TThreadPool::parallel_for(parts, [&](size_t t) {
+                size_t* h = &hist[t * 256];
+                for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i)
+                    ++h[(a[i].key >> shift) & 0xFF];
+            });
+            //      -    
+            bool trivial = false;
+            for (size_t d = 0; d < 256 && !trivial; ++d) {
+                size_t total = 0;
+                for (size_t t = 0; t < parts; ++t)
+                    total += hist[t * 256 + d];
+                trivial = total == n;
+            }
+            if (trivial)
+                continue;
+
+            size_t offset = 0;
+            for (size_t d = 0; d < 256; ++d)
+                for (size_t t = 0; t < parts; ++t) {
+                    const size_t c = hist[t * 256 + d];
+                    hist[t * 256 + d] = offset;
+                    offset += c;
+                }
+            TThreadPool::parallel_for(parts, [&](size_t t) {
+                size_t* h = &hist[t * 256];
+                for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i)
+                    tmp[h[(a[i].key >> shift) & 0xFF]++] = a[i];
+            });
+            a.swap(tmp);
+        }
+    }
+
+public:
+    TSparseBuilder(size_t rows, size_t cols) : nrows(rows), ncols(cols), id(next_id())
+    {
+        if (rows == 0 || cols == 0)
+            throw out_of_range("Matrix size should be greater than zero");
+        if (rows > MAX_VECTOR_SIZE || cols > MAX_VECTOR_SIZE)
+            throw out_of_range("Matrix size exceeds maximum allowed");
+    }
+
+    TSparseBuilder(const TSparseBuilder&) = delete;
+    TSparseBuilder& operator=(const TSparseBuilder&) = delete;
+
+    size_t rows() const noexcept { return nrows; }
+    size_t cols() const noexcept { return ncols; }
+
+    //      ,     build()
+    void add(size_t i, size_t j, const T& value)
+    {
+        if (i >= nrows || j >= ncols)
+            throw out_of_range("Triplet index out of range");
+        local().entries.push_back({ uint64_t(i) * ncols + j, value });
+    }
+
+    //    (  )
+    size_t size()
+    {
+        lock_guard<mutex> lock(m);
+        size_t n = 0;
+        for (const unique_ptr<TBuffer>& b : buffers)
+            n += b->entries.size();
+        return n;
+    }
+
+    //   :    ,  
+    size_t buffer_count()
+    {
+        lock_guard<mutex> lock(m);
+        return buffers.size();
+    }
+
+    void clear()
+    {
+        lock_guard<mutex> lock(m);
+        for (unique_ptr<TBuffer>& b : buffers)
+            b->entries.clear();
+    }
+
+    // CSR   ;   ,
+    //     
+    TSparseMatrixCSR<T> build()
+    {
+        lock_guard<mutex> lock(m);
+
+        //   
+        vector<size_t> offsets(buffers.size() + 1, 0);
+        for (size_t b = 0; b < buffers.size(); ++b)
+            offsets[b + 1] = offsets[b] + buffers[b]->entries.size();
+        const size_t n = offsets.back();
+        vector<TEntry> a(n), tmp(n);
+        TThreadPool::parallel_for(buffers.size(), [&](size_t b) {
+            std::copy(buffers[b]->entries.begin(), buffers[b]->entries.end(), a.begin() + offsets[b]);
+        });
+
+        unsigned bits = 0;
+        while (bits < 64 && (uint64_t(nrows) * ncols - 1) >> bits != 0)
+            ++bits;
+        radix_sort(a, tmp, bits);
+
+        //  :   ,    
+        //  ;    ,    
+        const size_t parts = csr_parts(n);
+        const size_t chunk = (n + parts - 1) / parts;
+        auto is_head = [&](size_t i) { return i == 0 || a[i].key != a[i - 1].key; };
+        vector<size_t> heads(parts + 1, 0);
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            size_t c = 0;
+            for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i)
+                c += is_head(i);
+            heads[t + 1] = c;
+        });
+        std::partial_sum(heads.begin(), heads.end(), heads.begin());
+
+        TSparseMatrixCSR<T> r(nrows, ncols);
+        const size_t nnz = heads.back();
+        r.colIdx.resize(nnz);
+        r.vals.resize(nnz);
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            size_t out = heads[t];
+            const size_t end = std::min(n, (t + 1) * chunk);
+            for (size_t i = t * chunk; i < end; ++i) {
+                if (!is_head(i))
+                    continue;
+                const uint64_t key = a[i].key;
+                T sum = a[i].value;
+                for (size_t k = i + 1; k < n && a[k].key == key; ++k)
+                    sum += a[k].value;
+                //          
+                const size_t row = size_t(key / ncols);
+                const size_t first = out == 0 ? 0 : size_t(a[i - 1].key / ncols) + 1;
+                for (size_t rr = first; rr <= row; ++rr)
+                    r.rowPtr[rr] = out;
+                r.colIdx[out] = index_type(key % ncols);
+                r.vals[out] = sum;
+                ++out;
+            }
+        });
+        const size_t last = nnz == 0 ? 0 : size_t(a[n - 1].key / ncols) + 1;
+        for (size_t rr = last; rr <= nrows; ++rr)
+            r.rowPtr[rr] = nnz;
+        return r;
+    }
+};
+
+#endif
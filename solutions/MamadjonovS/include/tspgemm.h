@@ -0,0 +1,324 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//    (SpGEMM),     
+
+#ifndef __TSpGemm_H__
+#define __TSpGemm_H__
+
+#include <algorithm>
+#include <numeric>
+
+#include "tsparse.h"
+
+using namespace std;
+
+//    -
+//  C[i] =  A[i][k] * B[k]    -
+//   2 * flops ( ,    L1),
+//        B    (SPA,
+//  ,  ,    ).
+//    ,    
+template<typename T>
+class TSpAccumulator
+{
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+    static constexpr index_type EMPTY = index_type(-1);
+
+    vector<T> dense;
+    vector<size_t> mark;
+    size_t stamp = 0;
+    vector<index_type> keys;
+    vector<T> hvals;
+    vector<size_t> slots;
+    vector<index_type> cols;
+
+public:
+    // SPA ,   flops    cols / SPA_RATIO
+    static constexpr size_t SPA_RATIO = 16;
+
+    //   j    2^bits :   
+    //  2^64 / phi.       2^m ,
+    //       
+    static size_t slot(index_type j, unsigned bits) noexcept
+    {
+        return size_t((uint64_t(j) * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+    }
+
+    //  i ;    (Numeric = false)
+    //    .    
+    template<bool Numeric>
+    size_t row(const TSparseMatrixCSR<T>& a, const TSparseMatrixCSR<T>& b, size_t i, size_t flops,
+               index_type* out_cols, T* out_vals)
+    {
+        const vector<size_t>& arp = a.row_ptr();
+        const vector<index_type>& aci = a.col_idx();
+        const vector<T>& ava = a.values();
+        const vector<size_t>& brp = b.row_ptr();
+        const vector<index_type>& bci = b.col_idx();
+        const vector<T>& bva = b.values();
+
+        if (flops * SPA_RATIO >= b.cols()) {
+            if (mark.size() < b.cols())
+                mark.assign(b.cols(), 0);
+            if (Numeric && dense.size() < b.cols())
+                dense.resize(b.cols());
+            ++stamp;
+            cols.clear();
+            for (size_t p = arp[i]; p < arp[i + 1]; ++p) {
+                const size_t k = aci[p];
+                for (size_t q = brp[k]; q < brp[k + 1]; ++q) {
+                    const index_type j = bci[q];
+                    if (mark[j] != stamp) {
+                        mark[j] = stamp;
+                        cols.push_back(j);
+                        if (Numeric)
+                            dense[j] = ava[p] * bva[q];
+                    }
+                    else if (Numeric) {
+                        dense[j] += ava[p] * bva[q];
+                    }
+                }
+            }
+            if (Numeric) {
+                std::sort(cols.begin(), cols.end());
+                for (size_t n = 0; n < cols.size(); ++n) {
+                    out_cols[n] = cols[n];
+                    out_vals[n] = dense[cols[n]];
+                }
+            }
+            return cols.size();
+        }
+
+        size_t cap = 16;
+        unsigned bits = 4;
+        while (cap < 2 * flops) {
+            cap *= 2;
+            ++bits;
+        }
+        keys.assign(cap, EMPTY);
+        if (Numeric)
+            hvals.resize(cap);
+        slots.clear();
+        for (size_t p = arp[i]; p < arp[i + 1]; ++p) {
+            const size_t k = aci[p];
+            for (size_t q = brp[k]; q < brp[k + 1]; ++q) {
+                const index_type j = bci[q];
+                size_t s = slot(j, bits);
+                while (keys[s] != j && keys[s] != EMPTY)
+                    s = (s + 1) & (cap - 1);
+                if (keys[s] == EMPTY) {
+                    keys[s] = j;
+                    slots.push_back(s);
+                    if (Numeric)
+                        hvals[s] = ava[p] * bva[q];
+                }
+                else if (Numeric) {
+                    hvals[s] += ava[p] * bva[q];
+                }
+            }
+        }
+        if (Numeric) {
+            std::sort(slots.begin(), slots.end(), [&](size_t x, size_t y) { return keys[x] < keys[y]; });
+            for (size_t n = 0; n < slots.size(); ++n) {
+                out_cols[n] = keys[slots[n]];
+                out_vals[n] = hvals[slots[n]];
+            }
+        }
+        return slots.size();
+    }
+};
+
+//    -
+// C = A * B   :     C,
+//      .    
+//   flops (   B,   A),     
+template<typename T>
+struct TSpGemm
+{
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+
+    // flops[i + 1] - flops[i] =     i
+    static vector<size_t> row_flops(const TSparseMatrixCSR<T>& a, const TSparseMatrixCSR<T>& b)
+    {
+        vector<size_t> flops(a.rows() + 1, 0);
+        const vector<size_t>& arp = a.row_ptr();
+        const vector<index_type>& aci = a.col_idx();
+        const vector<size_t>& brp = b.row_ptr();
+        TThreadPool::parallel_blocks(a.rows(), std::max<size_t>(1, SPARSE_GRAIN / std::max<size_t>(1, a.nnz() / a.rows())),
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    size_t f = 0;
+                    for (size_t p = arp[i]; p < arp[i + 1]; ++p)
+                        f += brp[aci[p] + 1] - brp[aci[p]];
+                    flops[i + 1] = f;
+                }
+            });
+        std::partial_sum(flops.begin(), flops.end(), flops.begin());
+        return flops;
+    }
+
+    static TSparseMatrixCSR<T> multiply(const TSparseMatrixCSR<T>& a, const TSparseMatrixCSR<T>& b)
+    {
+        if (a.cols() != b.rows())
+            throw invalid_argument("Matrix inner dimensions must agree for multiplication");
+
+        const vector<size_t> flops = row_flops(a, b);
+        const size_t parts = csr_parts(flops.back());
+        const vector<size_t> bounds = csr_partition(flops, parts);
+        TSparseMatrixCSR<T> c(a.rows(), b.cols());
+
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            TSpAccumulator<T> acc;
+            for (size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+                c.rowPtr[i + 1] = acc.template row<false>(a, b, i, flops[i + 1] - flops[i], nullptr, nullptr);
+        });
+        std::partial_sum(c.rowPtr.begin(), c.rowPtr.end(), c.rowPtr.begin());
+        c.colIdx.resize(c.rowPtr.back());
+        c.vals.resize(c.rowPtr.back());
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            TSpAccumulator<T> acc;
+            for (size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+                acc.template row<true>(a, b, i, flops[i + 1] - flops[i],
+                                       c.colIdx.data() + c.rowPtr[i], c.vals.data() + c.rowPtr[i]);
+        });
+        return c;
+    }
+
+    //          
+    static constexpr size_t GALLOP_RATIO = 32;
+
+    //     -
+    // on_match(p, q)    ac[p] == bc[q].    -
+    // ,        
+    //    ,  O(short * log(long))
+    template<typename F>
+    static void intersect(const index_type* ac, size_t na, const index_type* bc, size_t nb, F on_match)
+    {
+        if (na * GALLOP_RATIO < nb || nb * GALLOP_RATIO < na) {
+            const bool flipped = na > nb;
+            const index_type* sc = flipped ? bc : ac;
+            const index_type* lc = flipped ? ac : bc;
+            const size_t ns = flipped ? nb : na, nl = flipped ? na : nb;
+            size_t q = 0;
+            for (size_t p = 0; p < ns && q < nl; ++p) {
+                q = size_t(std::lower_bound(lc + q, lc + nl, sc[p]) - lc);
+                if (q < nl && lc[q] == sc[p]) {
+                    if (flipped)
+                        on_match(q, p);
+                    else
+                        on_match(p, q);
+                    ++q;
+                }
+            }
+            return;
+        }
+        size_t p = 0, q = 0;
+        while (p < na && q < nb) {
+            if (ac[p] < bc[q])
+                ++p;
+            else if (bc[q] < ac[p])
+                ++q;
+            else
+                on_match(p++, q++);
+        }
+    }
+
+    //    C<M> = A * B -
+    //    (i, j)  M: C[i][j] - 
+    //   i  A   j  bt = B^T (
+    //   j  B),    .
+    //         
+    template<typename TM>
+    static TSparseMatrixCSR<T> multiply_masked(const TSparseMatrixCSR<TM>& mask, const TSparseMatrixCSR<T>& a,
+                                               const TSparseMatrixCSR<T>& bt)
+    {
+        if (a.cols() != bt.cols())
+            throw invalid_argument("Matrix inner dimensions must agree for multiplication");
+        if (mask.rows() != a.rows() || mask.cols() != bt.rows())
+            throw invalid_argument("Mask size must match the product size");
+
+        const vector<size_t>& mrp = mask.row_ptr();
+        const vector<index_type>& mci = mask.col_idx();
+        const vector<size_t>& arp = a.row_ptr();
+        const vector<size_t>& brp = bt.row_ptr();
+
+        //      ,    
+        vector<T> dots(mask.nnz());
+        vector<char> found(mask.nnz(), 0);
+        TSparseMatrixCSR<T> c(a.rows(), bt.rows());
+        auto rows_range = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const index_type* ac = a.col_idx().data() + arp[i];
+                const T* av = a.values().data() + arp[i];
+                size_t n = 0;
+                for (size_t m = mrp[i]; m < mrp[i + 1]; ++m) {
+                    const size_t j = mci[m];
+                    const T* bv = bt.values().data() + brp[j];
+                    T sum = T();
+                    intersect(ac, arp[i + 1] - arp[i], bt.col_idx().data() + brp[j], brp[j + 1] - brp[j],
+                        [&](size_t p, size_t q) {
+                            sum += av[p] * bv[q];
+                            found[m] = 1;
+                        });
+                    dots[m] = sum;
+                    n += found[m];
+                }
+                c.rowPtr[i + 1] = n;
+            }
+        };
+        const size_t parts = csr_parts(mask.nnz());
+        const vector<size_t> bounds = csr_partition(mrp, parts);
+        TThreadPool::parallel_for(parts, [&](size_t t) { rows_range(bounds[t], bounds[t + 1]); });
+
+        std::partial_sum(c.rowPtr.begin(), c.rowPtr.end(), c.rowPtr.begin());
+        c.colIdx.resize(c.rowPtr.back());
+        c.vals.resize(c.rowPtr.back());
+        TThreadPool::parallel_for(parts, [&](size_t t) {
+            for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+                size_t out = c.rowPtr[i];
+                for (size_t m = mrp[i]; m < mrp[i + 1]; ++m)
+                    if (found[m]) {
+                        c.colIdx[out] = mci[m];
+                        c.vals[out++] = dots[m];
+                    }
+            }
+        });
+        return c;
+    }
+
+    //      
+    //   (    ).
+    //   C<L> = L * L^T     L:
+    //  (i, j), j < i,  |L[i] & L[j]|   
+    // k < j,        .
+    // L -   uint64_t,  C<L>  multiply_masked(L, L, L)
+    static uint64_t triangle_count(const TSparseMatrixCSR<T>& a)
+    {
+        if (a.rows() != a.cols())
+            throw invalid_argument("Adjacency matrix must be square");
+
+        const vector<size_t>& rp = a.row_ptr();
+        const index_type* ci = a.col_idx().data();
+        const size_t grain = std::max<size_t>(1, SPARSE_GRAIN / std::max<size_t>(1, a.nnz() / a.rows()));
+        vector<size_t> lp(a.rows() + 1, 0);
+        TThreadPool::parallel_blocks(a.rows(), grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                lp[i + 1] = size_t(std::lower_bound(ci + rp[i], ci + rp[i + 1], index_type(i)) - (ci + rp[i]));
+        });
+        std::partial_sum(lp.begin(), lp.end(), lp.begin());
+        vector<index_type> lc(lp.back());
+        TThreadPool::parallel_blocks(a.rows(), grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                std::copy(ci + rp[i], ci + rp[i] + (lp[i + 1] - lp[i]), lc.begin() + lp[i]);
+        });
+        const size_t nnz = lc.size();
+        const TSparseMatrixCSR<uint64_t> l(a.rows(), a.cols(), std::move(lp), std::move(lc), vector<uint64_t>(nnz, 1));
+
+        const TSparseMatrixCSR<uint64_t> c = TSpGemm<uint64_t>::multiply_masked(l, l, l);
+        return std::accumulate(c.values().begin(), c.values().end(), uint64_t(0));
+    }
+};
+
+#endif
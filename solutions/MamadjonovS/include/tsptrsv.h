@@ -0,0 +1,138 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//      
+
+#ifndef __TSpTrsv_H__
+#define __TSpTrsv_H__
+
+#include <algorithm>
+#include <numeric>
+
+#include "tsparse.h"
+
+using namespace std;
+
+//       -
+//        CSR  :
+//        ,  
+//  ,        
+// .      (Lower:
+// j <= i, Upper: j >= i),  L  U    LU 
+//       .    
+template<typename T>
+class TSpTrsv
+{
+public:
+    enum class Triangle { Lower, Upper };
+    using index_type = typename TSparseMatrixCSR<T>::index_type;
+
+private:
+    Triangle tri;
+    bool unit;
+    size_t n, count;
+    vector<size_t> diagPos;
+    vector<char> hasDiag;
+    vector<size_t> levelPtr;
+    vector<index_type> levelRows;
+    size_t grain;
+
+    //   i:  Lower -  ,  Upper - 
+    size_t deps_begin(const vector<size_t>& rp, size_t i) const noexcept
+    {
+        return tri == Triangle::Lower ? rp[i] : diagPos[i] + hasDiag[i];
+    }
+
+    size_t deps_end(const vector<size_t>& rp, size_t i) const noexcept
+    {
+        return tri == Triangle::Lower ? diagPos[i] : rp[i + 1];
+    }
+
+public:
+    TSpTrsv(const TSparseMatrixCSR<T>& a, Triangle triangle, bool unit_diagonal = false)
+        : tri(triangle), unit(unit_diagonal), n(a.rows()), count(a.nnz()), diagPos(a.rows()), hasDiag(a.rows(), 0)
+    {
+        if (a.rows() != a.cols())
+            throw invalid_argument("Triangular solve needs a square matrix");
+
+        const vector<size_t>& rp = a.row_ptr();
+        const vector<index_type>& ci = a.col_idx();
+        for (size_t i = 0; i < n; ++i) {
+            const auto first = ci.begin() + rp[i], last = ci.begin() + rp[i + 1];
+            const auto it = std::lower_bound(first, last, index_type(i));
+            diagPos[i] = size_t(it - ci.begin());
+            hasDiag[i] = it != last && *it == i;
+            if (!unit && !hasDiag[i])
+                throw invalid_argument("Triangular matrix has no diagonal element");
+        }
+
+        // :      
+        vector<size_t> level(n, 0);
+        size_t depth = 0;
+        for (size_t s = 0; s < n; ++s) {
+            const size_t i = tri == Triangle::Lower ? s : n - 1 - s;
+            size_t l = 0;
+            for (size_t k = deps_begin(rp, i); k < deps_end(rp, i); ++k)
+                l = std::max(l, level[ci[k]] + 1);
+            level[i] = l;
+            depth = std::max(depth, l + 1);
+        }
+
+        //    ;   -   
+        levelPtr.assign(depth + 1, 0);
+        for (size_t i = 0; i < n; ++i)
+            ++levelPtr[level[i] + 1];
+        std::partial_sum(levelPtr.begin(), levelPtr.end(), levelPtr.begin());
+        levelRows.resize(n);
+        vector<size_t> next(levelPtr.begin(), levelPtr.end() - 1);
+        for (size_t i = 0; i < n; ++i)
+            levelRows[next[level[i]]++] = index_type(i);
+        grain = std::max<size_t>(1, SPARSE_GRAIN / std::max<size_t>(1, count / n));
+    }
+
+    size_t size() const noexcept { return n; }
+    size_t levels() const noexcept { return levelPtr.size() - 1; }
+    Triangle triangle() const noexcept { return tri; }
+
+    //   l: levelRows[level_ptr[l] .. level_ptr[l + 1])
+    const vector<size_t>& level_ptr() const noexcept { return levelPtr; }
+    const vector<index_type>& level_rows() const noexcept { return levelRows; }
+
+    // x = T^-1 b      ,   ;
+    // x  b    
+    void solve(const TSparseMatrixCSR<T>& a, const TDynamicVector<T>& b, TDynamicVector<T>& x) const
+    {
+        if (a.rows() != n || a.nnz() != count)
+            throw invalid_argument("Matrix pattern differs from the analysed one");
+        if (b.size() != n || x.size() != n)
+            throw invalid_argument("Vector sizes must match matrix for triangular solve");
+
+        const vector<size_t>& rp = a.row_ptr();
+        const index_type* ci = a.col_idx().data();
+        const T* va = a.values().data();
+        const T* pb = b.data();
+        T* px = x.data();
+        for (size_t l = 0; l < levels(); ++l) {
+            const size_t first = levelPtr[l];
+            TThreadPool::parallel_blocks(levelPtr[l + 1] - first, grain, [&](size_t begin, size_t end) {
+                for (size_t r = first + begin; r < first + end; ++r) {
+                    const size_t i = levelRows[r];
+                    T s = pb[i];
+                    for (size_t k = deps_begin(rp, i); k < deps_end(rp, i); ++k)
+                        s -= va[k] * px[ci[k]];
+                    px[i] = unit ? s : s / va[diagPos[i]];
+                }
+            });
+        }
+    }
+
+    TDynamicVector<T> solve(const TSparseMatrixCSR<T>& a, const TDynamicVector<T>& b) const
+    {
+        TDynamicVector<T> x(n);
+        solve(a, b, x);
+        return x;
+    }
+};
+
+#endif
@@ -0,0 +1,183 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//     
+
+#ifndef __TSymmetric_H__
+#define __TSymmetric_H__
+
+#include "tpacked.h"
+
+using namespace std;
+
+//   -
+//    (j >= i)   ,  
+// TUpperTriangularMatrix; a[i][j]  a[j][i] -     
+template<typename T>
+class TSymmetricMatrix : public TPackedMatrix<TSymmetricMatrix<T>, T>
+{
+    using Base = TPackedMatrix<TSymmetricMatrix<T>, T>;
+    friend Base;
+    using Base::sz;
+    using Base::pMem;
+
+    T* row(size_t i) noexcept { return pMem + offset(sz, i); }
+    const T* row(size_t i) const noexcept { return pMem + offset(sz, i); }
+
+    TSymmetricMatrix(size_t s, typename Base::no_init_t) : Base(s, Base::no_init) {}
+
+    // y[begin, end) ,      y:  
+    //   y[i]      
+    //     ,    -
+    //   [begin, end).    y 
+    //  n ,          
+    void multiply_rows(size_t begin, size_t end, const T* x, T* y) const
+    {
+        std::fill(y + begin, y + end, T());
+        for (size_t j = 0; j < begin; ++j)
+            TVectorKernels<T>::axpy(x[j], row(j) + (begin - j), y + begin, end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            const T* r = row(i);
+            y[i] += r[0] * x[i] + TVectorKernels<T>::dot(r + 1, x + i + 1, sz - i - 1);
+            TVectorKernels<T>::axpy(x[i], r + 1, y + i + 1, end - i - 1);
+        }
+    }
+
+public:
+    static const char* kind_name() noexcept { return "Symmetric"; }
+    static size_t packed_size(size_t s) noexcept { return s * (s + 1) / 2; }
+    static size_t offset(size_t s, size_t i) noexcept { return i * s - i * (i - 1) / 2; }
+
+    TSymmetricMatrix(size_t s = 1) : Base(s) {}
+
+    //    ,   
+    explicit TSymmetricMatrix(const TDynamicMatrix<T>& m) : Base(m.size(), Base::no_init)
+    {
+        for (size_t i = 0; i < sz; ++i) {
+            const T* src = m[i].data();
+            std::copy(src + i, src + sz, row(i));
+        }
+    }
+
+    template<typename E, typename = TExprSameKind<E, TSymmetricMatrix>>
+    TSymmetricMatrix(const TExpr<E>& e) : Base(e.self().size(), Base::no_init)
+    {
+        expr_assign(e.self(), pMem, false);
+    }
+
+    using Base::operator=;
+    using Base::operator*;
+
+    // : [i][j]   j >= i
+    TPackedRow<T> operator[](size_t ind)
+    {
+        return TPackedRow<T>(row(ind), ind, sz);
+    }
+
+    TPackedRow<const T> operator[](size_t ind) const
+    {
+        return TPackedRow<const T>(row(ind), ind, sz);
+    }
+
+    //     
+    T& operator()(size_t i, size_t j)
+    {
+        return i <= j ? row(i)[j - i] : row(j)[i - j];
+    }
+
+    const T& operator()(size_t i, size_t j) const
+    {
+        return i <= j ? row(i)[j - i] : row(j)[i - j];
+    }
+
+    //   
+    T& at(size_t i, size_t j)
+    {
+        if (i >= sz || j >= sz)
+            throw out_of_range("Index out of range in at()");
+        return (*this)(i, j);
+    }
+
+    const T& at(size_t i, size_t j) const
+    {
+        if (i >= sz || j >= sz)
+            throw out_of_range("Index out of range in at() const");
+        return (*this)(i, j);
+    }
+
+    T get(size_t i, size_t j) const
+    {
+        return (*this)(i, j);
+    }
+
+    // - .     
+    //        y[i],  y[j];   
+    //        y,   y  
+    //  ,      
+    //  
+    TDynamicVector<T> operator*(const TDynamicVector<T>& v) const
+    {
+        if (sz != v.size())
+            throw invalid_argument("Matrix columns must equal vector size for multiplication");
+
+        TDynamicVector<T> result(sz);
+        const T* x = v.data();
+        T* y = result.data();
+        TThreadPool::parallel_blocks(sz, std::max<size_t>(1, EXPR_GRAIN / sz), [&](size_t begin, size_t end) {
+            multiply_rows(begin, end, x, y);
+        });
+        return result;
+    }
+
+    //    
+    TDynamicMatrix<T> to_dense() const
+    {
+        TDynamicMatrix<T> m(sz);
+        for (size_t i = 0; i < sz; ++i) {
+            const T* r = row(i);
+            std::copy(r, r + sz - i, m[i].data() + i);
+            for (size_t j = i + 1; j < sz; ++j)
+                m[j][i] = r[j - i];
+        }
+        return m;
+    }
+
+    // A + A^T:     
+    static TSymmetricMatrix sum_with_transpose(const TDynamicMatrix<T>& m)
+    {
+        TSymmetricMatrix s(m.size(), Base::no_init);
+        for (size_t i = 0; i < s.sz; ++i) {
+            T* r = s.row(i);
+            const T* src = m[i].data();
+            for (size_t j = i; j < s.sz; ++j)
+                r[j - i] = src[j] + m[j][i];
+        }
+        return s;
+    }
+
+    //   A^T * A:    ,
+    //     ,    
+    static TSymmetricMatrix gram(const TDynamicMatrix<T>& a)
+    {
+        const size_t n = a.size();
+        TSymmetricMatrix g(n);
+        auto body = [&](size_t i) {
+            T* r = g.row(i);
+            for (size_t k = 0; k < n; ++k) {
+                const T* ak = a[k].data();
+                TVectorKernels<T>::axpy(ak[i], ak + i, r, n - i);
+            }
+        };
+        if (n * n * n / 2 < TGemm<T>::PARALLEL_FLOPS) {
+            for (size_t i = 0; i < n; ++i)
+                body(i);
+        }
+        else {
+            TThreadPool::parallel_for(n, body);
+        }
+        return g;
+    }
+};
+
+#endif
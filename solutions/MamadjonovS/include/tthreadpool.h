@@ -0,0 +1,322 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//      (work stealing)   
+
+#ifndef __TThreadPool_H__
+#define __TThreadPool_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+//   -
+//      :     ,
+//        .
+//     ,   (
+//     threads - 1 )    ,
+//        
+class TThreadPool
+{
+    //  ,     
+    struct TJob
+    {
+        void (*invoke)(void* body, size_t task);
+        void* body;
+        size_t count;
+        atomic<size_t> next;
+        size_t helpers;
+        mutex m;
+        condition_variable done;
+        exception_ptr error;
+
+        //    ;    
+        void run()
+        {
+            for (size_t t = next.fetch_add(1); t < count; t = next.fetch_add(1)) {
+                try {
+                    invoke(body, t);
+                }
+                catch (...) {
+                    lock_guard<mutex> lock(m);
+                    if (!error)
+                        error = current_exception();
+                    next.store(count);
+                }
+            }
+        }
+
+        void leave()
+        {
+            lock_guard<mutex> lock(m);
+            if (--helpers == 0)
+                done.notify_one();
+        }
+    };
+
+    //  -    :     
+    //      ,   
+    //      
+    struct TWorkQueue
+    {
+        static constexpr size_t RESERVE = 16;
+
+        mutex m;
+        vector<TJob*> jobs;
+
+        TWorkQueue() { jobs.reserve(RESERVE); }
+    };
+
+    vector<unique_ptr<TWorkQueue>> queues;
+    vector<thread> workers;
+    mutex sleep_mutex;
+    condition_variable wake;
+    size_t queued = 0;
+    bool stopping = false;
+    size_t next_queue = 0;
+
+    static size_t& global_threads() noexcept
+    {
+        static size_t n = std::max<size_t>(1, thread::hardware_concurrency());
+        return n;
+    }
+
+    static size_t& scoped_threads() noexcept
+    {
+        static thread_local size_t n = 0;
+        return n;
+    }
+
+    //      
+    static bool& inside() noexcept
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    explicit TThreadPool(size_t n)
+    {
+        start(n);
+    }
+
+    void start(size_t n)
+    {
+        stopping = false;
+        queued = 0;
+        queues.clear();
+        for (size_t i = 0; i + 1 < n; ++i)
+            queues.push_back(unique_ptr<TWorkQueue>(new TWorkQueue));
+        for (size_t i = 0; i + 1 < n; ++i)
+            workers.emplace_back([this, i] { work(i); });
+    }
+
+    void stop()
+    {
+        {
+            lock_guard<mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& w : workers)
+            w.join();
+        workers.clear();
+    }
+
+    bool take(size_t self, TJob*& job)
+    {
+        //     ,    
+        for (size_t k = 0; k < queues.size(); ++k) {
+            const size_t q = (self + k) % queues.size();
+            TWorkQueue& wq = *queues[q];
+            lock_guard<mutex> lock(wq.m);
+            if (wq.jobs.empty())
+                continue;
+            if (k == 0) {
+                job = wq.jobs.back();
+                wq.jobs.pop_back();
+            }
+            else {
+                job = wq.jobs.front();
+                wq.jobs.erase(wq.jobs.begin());
+            }
+            lock_guard<mutex> sleep(sleep_mutex);
+            --queued;
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t self)
+    {
+        inside() = true;
+        for (;;) {
+            TJob* job;
+            if (take(self, job)) {
+                job->run();
+                job->leave();
+                continue;
+            }
+            unique_lock<mutex> lock(sleep_mutex);
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued == 0)
+                return;
+        }
+    }
+
+    //    ,      
+    size_t withdraw(TJob* job)
+    {
+        size_t removed = 0;
+        for (unique_ptr<TWorkQueue>& q : queues) {
+            lock_guard<mutex> lock(q->m);
+            const auto it = std::remove(q->jobs.begin(), q->jobs.end(), job);
+            removed += size_t(q->jobs.end() - it);
+            q->jobs.erase(it, q->jobs.end());
+        }
+        lock_guard<mutex> sleep(sleep_mutex);
+        queued -= removed;
+        return removed;
+    }
+
+    void execute(TJob& job, size_t helpers)
+    {
+        job.helpers = helpers;
+        size_t first;
+        {
+            lock_guard<mutex> sleep(sleep_mutex);
+            queued += helpers;
+            first = next_queue;
+            next_queue += helpers;
+        }
+        for (size_t h = 0; h < helpers; ++h) {
+            TWorkQueue& q = *queues[(first + h) % queues.size()];
+            lock_guard<mutex> lock(q.m);
+            q.jobs.push_back(&job);
+        }
+        if (helpers == 1)
+            wake.notify_one();
+        else
+            wake.notify_all();
+
+        inside() = true;
+        job.run();
+        inside() = false;
+
+        const size_t removed = withdraw(&job);
+        unique_lock<mutex> lock(job.m);
+        job.helpers -= removed;
+        job.done.wait(lock, [&job] { return job.helpers == 0; });
+        if (job.error)
+            rethrow_exception(job.error);
+    }
+
+public:
+    friend class TThreadScope;
+
+    TThreadPool(const TThreadPool&) = delete;
+    TThreadPool& operator=(const TThreadPool&) = delete;
+
+    ~TThreadPool()
+    {
+        stop();
+    }
+
+    static TThreadPool& instance()
+    {
+        static TThreadPool pool(global_threads());
+        return pool;
+    }
+
+    //        (0 -   );
+    //      
+    static void set_threads(size_t n)
+    {
+        if (n == 0)
+            n = std::max<size_t>(1, thread::hardware_concurrency());
+        global_threads() = n;
+        TThreadPool& pool = instance();
+        if (pool.workers.size() + 1 != n) {
+            pool.stop();
+            pool.start(n);
+        }
+    }
+
+    //  ,   
+    static size_t threads() noexcept
+    {
+        if (inside())
+            return 1;
+        const size_t scoped = scoped_threads();
+        return scoped != 0 ? std::min(scoped, global_threads()) : global_threads();
+    }
+
+    // body(task)  task  [0, count);      
+    //         
+    template<typename F>
+    static void parallel_for(size_t count, F&& body)
+    {
+        const size_t n = std::min(threads(), count);
+        if (n <= 1) {
+            for (size_t t = 0; t < count; ++t)
+                body(t);
+            return;
+        }
+        TJob job;
+        job.invoke = [](void* b, size_t t) { (*static_cast<typename remove_reference<F>::type*>(b))(t); };
+        job.body = &body;
+        job.count = count;
+        job.next.store(0);
+        instance().execute(job, n - 1);
+    }
+
+    // body(begin, end)     grain ;  
+    //    ,       
+    template<typename F>
+    static void parallel_blocks(size_t n, size_t grain, F&& body)
+    {
+        const size_t p = threads();
+        if (p <= 1 || n <= grain) {
+            body(size_t(0), n);
+            return;
+        }
+        //        
+        size_t block = std::max(grain, (n + 4 * p - 1) / (4 * p));
+        block = (block + grain - 1) / grain * grain;
+        const size_t count = (n + block - 1) / block;
+        parallel_for(count, [&](size_t t) {
+            const size_t begin = t * block;
+            body(begin, std::min(n, begin + block));
+        });
+    }
+};
+
+//    -
+//   ,       
+class TThreadScope
+{
+    size_t saved;
+public:
+    explicit TThreadScope(size_t n) : saved(TThreadPool::scoped_threads())
+    {
+        TThreadPool::scoped_threads() = std::max<size_t>(1, n);
+    }
+
+    TThreadScope(const TThreadScope&) = delete;
+    TThreadScope& operator=(const TThreadScope&) = delete;
+
+    ~TThreadScope()
+    {
+        TThreadPool::scoped_threads() = saved;
+    }
+};
+
+#endif
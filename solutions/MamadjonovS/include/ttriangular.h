@@ -0,0 +1,288 @@
+// , ,  "   "
+//
+// Copyright (c)  ..
+//
+//     
+
+#ifndef __TTriangular_H__
+#define __TTriangular_H__
+
+#include "tpacked.h"
+
+using namespace std;
+
+template<typename T> class TLowerTriangularMatrix;
+
+//    -
+//    j >= i,   :
+//  i  n - i    i * n - i * (i - 1) / 2
+template<typename T>
+class TUpperTriangularMatrix : public TPackedMatrix<TUpperTriangularMatrix<T>, T>
+{
+    using Base = TPackedMatrix<TUpperTriangularMatrix<T>, T>;
+    friend Base;
+    friend class TLowerTriangularMatrix<T>;
+    using Base::sz;
+    using Base::pMem;
+
+    T* row(size_t i) noexcept { return pMem + offset(sz, i); }
+    const T* row(size_t i) const noexcept { return pMem + offset(sz, i); }
+
+    TUpperTriangularMatrix(size_t s, typename Base::no_init_t) : Base(s, Base::no_init) {}
+
+public:
+    static const char* kind_name() noexcept { return "Upper triangular"; }
+    static size_t packed_size(size_t s) noexcept { return s * (s + 1) / 2; }
+    static size_t offset(size_t s, size_t i) noexcept { return i * s - i * (i - 1) / 2; }
+
+    TUpperTriangularMatrix(size_t s = 1) : Base(s) {}
+
+    //    ;    
+    explicit TUpperTriangularMatrix(const TDynamicMatrix<T>& m) : Base(m.size(), Base::no_init)
+    {
+        for (size_t i = 0; i < sz; ++i) {
+            const T* src = m[i].data();
+            std::copy(src + i, src + sz, row(i));
+        }
+    }
+
+    template<typename E, typename = TExprSameKind<E, TUpperTriangularMatrix>>
+    TUpperTriangularMatrix(const TExpr<E>& e) : Base(e.self().size(), Base::no_init)
+    {
+        expr_assign(e.self(), pMem, false);
+    }
+
+    using Base::operator=;
+    using Base::operator*;
+
+    // : [i][j]   j >= i
+    TPackedRow<T> operator[](size_t ind)
+    {
+        return TPackedRow<T>(row(ind), ind, sz);
+    }
+
+    TPackedRow<const T> operator[](size_t ind) const
+    {
+        return TPackedRow<const T>(row(ind), ind, sz);
+    }
+
+    //   
+    TPackedRow<T> at(size_t ind)
+    {
+        if (ind >= sz)
+            throw out_of_range("Row index out of range in at()");
+        return TPackedRow<T>(row(ind), ind, sz);
+    }
+
+    TPackedRow<const T> at(size_t ind) const
+    {
+        if (ind >= sz)
+            throw out_of_range("Row index out of range in at() const");
+        return TPackedRow<const T>(row(ind), ind, sz);
+    }
+
+    //     
+    T get(size_t i, size_t j) const
+    {
+        return j >= i ? row(i)[j - i] : T();
+    }
+
+    // - : y[i] = ( i, x[i..n))
+    TDynamicVector<T> operator*(const TDynamicVector<T>& v) const
+    {
+        if (sz != v.size())
+            throw invalid_argument("Matrix columns must equal vector size for multiplication");
+
+        TDynamicVector<T> result(sz);
+        const T* x = v.data();
+        T* y = result.data();
+        TThreadPool::parallel_blocks(sz, std::max<size_t>(1, EXPR_GRAIN / sz), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                y[i] = TVectorKernels<T>::dot(row(i), x + i, sz - i);
+        });
+        return result;
+    }
+
+    //       :
+    // c[i][j] =  a[i][k] * b[k][j]  k  [i, j],  
+    //  ,      ,    n^3
+    TUpperTriangularMatrix operator*(const TUpperTriangularMatrix& m) const
+    {
+        if (sz != m.sz)
+            throw invalid_argument("Matrix sizes must be equal for multiplication");
+
+        TUpperTriangularMatrix result(sz);
+        auto body = [&](size_t i) {
+            const T* a = row(i);
+            T* c = result.row(i);
+            for (size_t k = i; k < sz; ++k)
+                TVectorKernels<T>::axpy(a[k - i], m.row(k), c + (k - i), sz - k);
+        };
+        if (sz * sz * sz / 6 < TGemm<T>::PARALLEL_FLOPS) {
+            for (size_t i = 0; i < sz; ++i)
+                body(i);
+        }
+        else {
+            //        
+            TThreadPool::parallel_for(sz, body);
+        }
+        return result;
+    }
+
+    //    
+    TDynamicMatrix<T> to_dense() const
+    {
+        TDynamicMatrix<T> m(sz);
+        for (size_t i = 0; i < sz; ++i)
+            std::copy(row(i), row(i) + sz - i, m[i].data() + i);
+        return m;
+    }
+
+    TLowerTriangularMatrix<T> transpose() const
+    {
+        TLowerTriangularMatrix<T> t(sz, TLowerTriangularMatrix<T>::no_init);
+        for (size_t i = 0; i < sz; ++i) {
+            const T* r = row(i);
+            for (size_t j = i; j < sz; ++j)
+                t.row(j)[i] = r[j - i];
+        }
+        return t;
+    }
+};
+
+//    -
+//    j <= i,   :
+//  i  i + 1    i * (i + 1) / 2
+template<typename T>
+class TLowerTriangularMatrix : public TPackedMatrix<TLowerTriangularMatrix<T>, T>
+{
+    using Base = TPackedMatrix<TLowerTriangularMatrix<T>, T>;
+    friend Base;
+    friend class TUpperTriangularMatrix<T>;
+    using Base::sz;
+    using Base::pMem;
+
+    T* row(size_t i) noexcept { return pMem + offset(i); }
+    const T* row(size_t i) const noexcept { return pMem + offset(i); }
+
+    TLowerTriangularMatrix(size_t s, typename Base::no_init_t) : Base(s, Base::no_init) {}
+
+public:
+    static const char* kind_name() noexcept { return "Lower triangular"; }
+    static size_t packed_size(size_t s) noexcept { return s * (s + 1) / 2; }
+    static size_t offset(size_t i) noexcept { return i * (i + 1) / 2; }
+
+    TLowerTriangularMatrix(size_t s = 1) : Base(s) {}
+
+    //    ;    
+    explicit TLowerTriangularMatrix(const TDynamicMatrix<T>& m) : Base(m.size(), Base::no_init)
+    {
+        for (size_t i = 0; i < sz; ++i) {
+            const T* src = m[i].data();
+            std::copy(src, src + i + 1, row(i));
+        }
+    }
+
+    template<typename E, typename = TExprSameKind<E, TLowerTriangularMatrix>>
+    TLowerTriangularMatrix(const TExpr<E>& e) : Base(e.self().size(), Base::no_init)
+    {
+        expr_assign(e.self(), pMem, false);
+    }
+
+    using Base::operator=;
+    using Base::operator*;
+
+    // : [i][j]   j <= i
+    TPackedRow<T> operator[](size_t ind)
+    {
+        return TPackedRow<T>(row(ind), 0, ind + 1);
+    }
+
+    TPackedRow<const T> operator[](size_t ind) const
+    {
+        return TPackedRow<const T>(row(ind), 0, ind + 1);
+    }
+
+    //   
+    TPackedRow<T> at(size_t ind)
+    {
+        if (ind >= sz)
+            throw out_of_range("Row index out of range in at()");
+        return TPackedRow<T>(row(ind), 0, ind + 1);
+    }
+
+    TPackedRow<const T> at(size_t ind) const
+    {
+        if (ind >= sz)
+            throw out_of_range("Row index out of range in at() const");
+        return TPackedRow<const T>(row(ind), 0, ind + 1);
+    }
+
+    //     
+    T get(size_t i, size_t j) const
+    {
+        return j <= i ? row(i)[j] : T();
+    }
+
+    // - : y[i] = ( i, x[0..i])
+    TDynamicVector<T> operator*(const TDynamicVector<T>& v) const
+    {
+        if (sz != v.size())
+            throw invalid_argument("Matrix columns must equal vector size for multiplication");
+
+        TDynamicVector<T> result(sz);
+        const T* x = v.data();
+        T* y = result.data();
+        TThreadPool::parallel_blocks(sz, std::max<size_t>(1, EXPR_GRAIN / sz), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                y[i] = TVectorKernels<T>::dot(row(i), x, i + 1);
+        });
+        return result;
+    }
+
+    //    : c[i][j] =  a[i][k] * b[k][j]
+    //  k  [j, i];  i      b
+    TLowerTriangularMatrix operator*(const TLowerTriangularMatrix& m) const
+    {
+        if (sz != m.sz)
+            throw invalid_argument("Matrix sizes must be equal for multiplication");
+
+        TLowerTriangularMatrix result(sz);
+        auto body = [&](size_t i) {
+            const T* a = row(i);
+            T* c = result.row(i);
+            for (size_t k = 0; k <= i; ++k)
+                TVectorKernels<T>::axpy(a[k], m.row(k), c, k + 1);
+        };
+        if (sz * sz * sz / 6 < TGemm<T>::PARALLEL_FLOPS) {
+            for (size_t i = 0; i < sz; ++i)
+                body(i);
+        }
+        else {
+            TThreadPool::parallel_for(sz, body);
+        }
+        return result;
+    }
+
+    //    
+    TDynamicMatrix<T> to_dense() const
+    {
+        TDynamicMatrix<T> m(sz);
+        for (size_t i = 0; i < sz; ++i)
+            std::copy(row(i), row(i) + i + 1, m[i].data());
+        return m;
+    }
+
+    TUpperTriangularMatrix<T> transpose() const
+    {
+        TUpperTriangularMatrix<T> t(sz, TUpperTriangularMatrix<T>::no_init);
+        for (size_t i = 0; i < sz; ++i) {
+            const T* r = row(i);
+            for (size_t j = 0; j <= i; ++j)
+                t.row(j)[i - j] = r[j];
+        }
+        return t;
+    }
+};
+
+#endif
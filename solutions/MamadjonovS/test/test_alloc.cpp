@@ -0,0 +1,41 @@
+#include "test_alloc.h"
+
+#include <cstdlib>
+#include <new>
+
+//   operator new  delete -
+//   :     ,
+//     free    new
+std::atomic<size_t> allocation_count(0);
+
+void* operator new(size_t n)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n == 0 ? 1 : n))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { ::operator delete(p); }
+
+void* operator new(size_t n, std::align_val_t al)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    const size_t a = size_t(al);
+#ifdef _MSC_VER
+    void* p = _aligned_malloc(n == 0 ? 1 : n, a);
+#else
+    void* p = std::aligned_alloc(a, (n + a - 1) / a * a + (n == 0 ? a : 0));
+#endif
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+#ifdef _MSC_VER
+void operator delete(void* p, std::align_val_t) noexcept { _aligned_free(p); }
+#else
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+#endif
+void operator delete(void* p, size_t, std::align_val_t al) noexcept { ::operator delete(p, al); }
@@ -0,0 +1,11 @@
+#ifndef __TestAlloc_H__
+#define __TestAlloc_H__
+
+#include <atomic>
+#include <cstddef>
+
+//     operator new    ,
+//   ;    test_alloc.cpp
+extern std::atomic<size_t> allocation_count;
+
+#endif
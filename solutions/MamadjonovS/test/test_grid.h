@@ -0,0 +1,27 @@
+#ifndef __TestGrid_H__
+#define __TestGrid_H__
+
+#include "tsparsebuilder.h"
+
+//     w x h -
+// 4 + shift  , -1    .  y * w + x 
+//  (y * w + x) * step % (w * h): step = 1 -  ,
+// ,    w * h,  
+inline TSparseMatrixCSR<double> make_grid_laplacian(size_t w, size_t h, double shift = 0.0, size_t step = 1)
+{
+    const size_t n = w * h;
+    auto label = [&](size_t x, size_t y) { return (y * w + x) * step % n; };
+    TSparseBuilder<double> b(n, n);
+    for (size_t y = 0; y < h; ++y)
+        for (size_t x = 0; x < w; ++x) {
+            const size_t v = label(x, y);
+            b.add(v, v, 4.0 + shift);
+            if (x > 0) b.add(v, label(x - 1, y), -1.0);
+            if (x + 1 < w) b.add(v, label(x + 1, y), -1.0);
+            if (y > 0) b.add(v, label(x, y - 1), -1.0);
+            if (y + 1 < h) b.add(v, label(x, y + 1), -1.0);
+        }
+    return b.build();
+}
+
+#endif
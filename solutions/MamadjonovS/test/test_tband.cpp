@@ -0,0 +1,118 @@
+#include "tband.h"
+
+#include <gtest.h>
+
+namespace
+{
+TBandMatrix<double> make_band(size_t n, size_t kl, size_t ku, int seed)
+{
+    TBandMatrix<double> m(n, kl, ku);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i > kl ? i - kl : 0; j < n && j <= i + ku; ++j)
+            m(i, j) = double(int((i * 5 + j * 3 + seed) % 9) - 4);
+    return m;
+}
+
+double max_error(const TDynamicVector<double>& a, const TDynamicVector<double>& b)
+{
+    double e = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        e = std::max(e, std::abs(a[i] - b[i]));
+    return e;
+}
+}
+
+TEST(TBandMatrix, can_create_band_matrix)
+{
+    ASSERT_NO_THROW(TBandMatrix<double> m(10, 2, 1));
+    ASSERT_ANY_THROW(TBandMatrix<double> m(0, 0, 0));
+    ASSERT_ANY_THROW(TBandMatrix<double> m(3, 3, 0));
+}
+
+TEST(TBandMatrix, uses_lapack_band_layout)
+{
+    TBandMatrix<int> m(4, 1, 2);
+    m(2, 1) = 5;
+    m(0, 2) = 7;
+
+    ASSERT_EQ(4u, m.leading_dimension());
+    EXPECT_EQ(5, m.data()[1 * 4 + 2 + 2 - 1]);
+    EXPECT_EQ(7, m.data()[2 * 4 + 2 + 0 - 2]);
+    EXPECT_EQ(0, m.get(3, 0));
+    ASSERT_ANY_THROW(m.at(3, 0));
+}
+
+TEST(TBandMatrix, converts_to_and_from_dense)
+{
+    TBandMatrix<double> b = make_band(12, 2, 3, 1);
+    EXPECT_EQ(b, TBandMatrix<double>(b.to_dense(), 2, 3));
+}
+
+TEST(TBandMatrix, matrix_vector_product_matches_dense)
+{
+    for (size_t n : { 1, 7, 5000 }) {
+        const size_t kl = std::min<size_t>(n - 1, 2), ku = std::min<size_t>(n - 1, 1);
+        TBandMatrix<double> b = make_band(n, kl, ku, 2);
+        TDynamicVector<double> x(n), expected(n);
+        for (size_t i = 0; i < n; ++i)
+            x[i] = double(i % 7) - 3;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                if (j + kl >= i && i + ku >= j)
+                    expected[i] += b(i, j) * x[j];
+
+        EXPECT_EQ(expected, b * x);
+        TThreadPool::set_threads(4);
+        EXPECT_EQ(expected, b * x);
+        TThreadPool::set_threads(0);
+    }
+}
+
+TEST(TBandMatrix, addition_widens_band)
+{
+    TBandMatrix<double> a = make_band(20, 1, 1, 3), b = make_band(20, 3, 0, 4);
+    TBandMatrix<double> s = a + b, d = a - b;
+
+    EXPECT_EQ(3u, s.lower());
+    EXPECT_EQ(1u, s.upper());
+    EXPECT_EQ(a.to_dense() + b.to_dense(), s.to_dense());
+    EXPECT_EQ(a.to_dense() - b.to_dense(), d.to_dense());
+    EXPECT_EQ(a.to_dense() * 2.0, (a * 2.0).to_dense());
+}
+
+TEST(TBandMatrix, solves_tridiagonal_system)
+{
+    const size_t n = 1000;
+    TBandMatrix<double> a(n, 1, 1);
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i) {
+        a(i, i) = 4;
+        if (i > 0) a(i, i - 1) = -1;
+        if (i + 1 < n) a(i, i + 1) = -1;
+        x[i] = double(i % 10);
+    }
+
+    EXPECT_LT(max_error(x, a.solve(a * x)), 1e-10);
+}
+
+TEST(TBandMatrix, solves_banded_system_that_needs_pivoting)
+{
+    const size_t n = 200;
+    TBandMatrix<double> a = make_band(n, 2, 3, 5);
+    for (size_t i = 0; i < n; ++i)
+        a(i, i) = i % 3 == 0 ? 0.0 : 1.0;
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = double(i % 4) - 1.5;
+
+    TBandLU<double> lu = a.factor();
+    TDynamicVector<double> b = a * x;
+    lu.solve_in_place(b);
+    EXPECT_LT(max_error(x, b), 1e-8);
+}
+
+TEST(TBandMatrix, throws_on_singular_matrix)
+{
+    TBandMatrix<double> a(4, 1, 1);
+    ASSERT_ANY_THROW(a.factor());
+}
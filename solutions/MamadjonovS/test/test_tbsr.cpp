@@ -0,0 +1,147 @@
+#include "tbsr.h"
+#include "tsparsebuilder.h"
+
+#include <gtest.h>
+
+namespace
+{
+//   3 x 3    :  
+//   ,     
+TSparseMatrixCSR<double> make_blocked(size_t nodes)
+{
+    TSparseBuilder<double> b(nodes * 3, nodes * 3);
+    for (size_t u = 0; u < nodes; ++u)
+        for (size_t v : { u, (u + 1) % nodes, (u * 7 + 3) % nodes, (u * 13 + 5) % nodes })
+            for (size_t r = 0; r < 3; ++r)
+                for (size_t c = 0; c < 3; ++c)
+                    b.add(u * 3 + r, v * 3 + c, double(int((u + v + r * 3 + c) % 9) - 4) + 0.5);
+    return b.build();
+}
+}
+
+TEST(TSparseMatrixBSR, requires_divisible_dimensions)
+{
+    ASSERT_NO_THROW((TSparseMatrixBSR<double, 3, 3>(9, 6)));
+    ASSERT_ANY_THROW((TSparseMatrixBSR<double, 3, 3>(10, 6)));
+    ASSERT_ANY_THROW((TSparseMatrixBSR<double, 2, 2>(make_blocked(5))));
+}
+
+TEST(TSparseMatrixBSR, detects_natural_block_size)
+{
+    TSparseMatrixCSR<double> a = make_blocked(40);
+    TBlockSize bs = bsr_detect_block(a);
+
+    EXPECT_EQ(3u, bs.rows);
+    EXPECT_EQ(3u, bs.cols);
+    EXPECT_EQ(a.nnz() / 9, bsr_block_count(a, 3, 3));
+}
+
+TEST(TSparseMatrixBSR, stores_one_index_per_block)
+{
+    TSparseMatrixCSR<double> a = make_blocked(40);
+    TSparseMatrixBSR<double, 3, 3> b(a);
+
+    EXPECT_EQ(a.nnz() / 9, b.blocks());
+    EXPECT_EQ(a.nnz(), b.values().size());
+    EXPECT_EQ(a, b.to_csr());
+    EXPECT_EQ(a.get(7, 5), b.get(7, 5));
+    EXPECT_EQ(a.get(0, 100), b.get(0, 100));
+}
+
+TEST(TSparseMatrixBSR, converts_matrix_with_partial_blocks)
+{
+    TSparseMatrixCSR<int> a(4, 4, { 0, 2, 3, 3, 4 }, { 0, 3, 1, 2 }, { 1, 2, 3, 4 });
+    TSparseMatrixBSR<int, 2, 2> b(a);
+
+    EXPECT_EQ(3u, b.blocks());
+    EXPECT_EQ(vector<int>({ 1, 0, 0, 3, 0, 2, 0, 0, 0, 0, 4, 0 }), b.values());
+    EXPECT_EQ(a, b.to_csr());
+}
+
+TEST(TSparseMatrixBSR, spmv_matches_csr_on_any_thread_count)
+{
+    TSparseMatrixCSR<double> a = make_blocked(3000);
+    TSparseMatrixBSR<double, 3, 3> b(a);
+    TDynamicVector<double> x(a.cols());
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = double(i % 7) - 3;
+
+    EXPECT_EQ(a * x, b * x);
+    TThreadPool::set_threads(4);
+    EXPECT_EQ(a * x, b * x);
+    TThreadPool::set_threads(0);
+}
+
+TEST(TSparseMatrixBSR, spmm_matches_column_by_column_spmv)
+{
+    TSparseMatrixCSR<double> a = make_blocked(200);
+    TSparseMatrixBSR<double, 3, 3> b(a);
+    const size_t n = a.rows();
+    TDynamicMatrix<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            x[i][j] = double((i * n + j) % 11) - 5;
+
+    TThreadPool::set_threads(4);
+    b.multiply(x, y);
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(y, b * x);
+    EXPECT_EQ(y, a * x);
+    for (size_t j = 0; j < n; ++j) {
+        TDynamicVector<double> xj(n), yj(n);
+        for (size_t i = 0; i < n; ++i)
+            xj[i] = x[i][j];
+        a.multiply(xj, yj);
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(yj[i], y[i][j]);
+    }
+    TDynamicMatrix<double> z(n + 3);
+    ASSERT_ANY_THROW(b.multiply(x, x));
+    ASSERT_ANY_THROW(b.multiply(x, z));
+}
+
+TEST(TSparseMatrixBSR, spmm_applies_rectangular_matrix_to_narrow_block)
+{
+    // A 6000 x 3000  3 x 2, k   n,    k
+    const size_t rows = 6000, cols = 3000;
+    TSparseBuilder<double> sb(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t q = 0; q < 4; ++q)
+            sb.add(i, (i / 2 + q * 577) % cols, double(int((i + q) % 7) - 3) + 0.5);
+    const TSparseMatrixCSR<double> a = sb.build();
+    const TSparseMatrixBSR<double, 3, 2> b(a);
+
+    for (size_t k : { 1, 8, 13 }) {
+        const size_t ldx = k + 2, ldy = k + 1;
+        vector<double> x(cols * ldx), y(rows * ldy), expected(rows * ldy);
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = double(int(i % 11) - 5);
+
+        a.multiply(x.data(), ldx, expected.data(), ldy, k);
+        TThreadPool::set_threads(4);
+        b.multiply(x.data(), ldx, y.data(), ldy, k);
+        TThreadPool::set_threads(0);
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = 0; j < k; ++j)
+                ASSERT_EQ(expected[i * ldy + j], y[i * ldy + j]) << "k = " << k << ", row " << i;
+    }
+    vector<double> x(cols * 4), y(rows * 4);
+    ASSERT_ANY_THROW(b.multiply(x.data(), 2, y.data(), 4, 4));
+    ASSERT_ANY_THROW(b.multiply(y.data(), 4, y.data(), 4, 4));
+}
+
+TEST(TSparseMatrixBSR, visit_converts_with_detected_block)
+{
+    TSparseMatrixCSR<double> a = make_blocked(40);
+    TDynamicVector<double> x(a.cols());
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = double(i % 5) - 2;
+
+    TDynamicVector<double> y = bsr_visit(a, [&](const auto& b) {
+        EXPECT_EQ(3u, b.block_height());
+        EXPECT_EQ(3u, b.block_width());
+        return b * x;
+    });
+    EXPECT_EQ(a * x, y);
+    EXPECT_GE(2u, bsr_visit(a, [](const auto& b) { return b.block_height(); }, 2));
+}
@@ -0,0 +1,227 @@
+#include "tkrylov.h"
+#include "tprecond.h"
+#include "tsparsebuilder.h"
+#include "test_alloc.h"
+#include "test_grid.h"
+
+#include <gtest.h>
+
+namespace
+{
+// -:     
+TSparseMatrixCSR<double> make_convection(size_t w, size_t h)
+{
+    TSparseBuilder<double> b(w * h, w * h);
+    for (size_t y = 0; y < h; ++y)
+        for (size_t x = 0; x < w; ++x) {
+            const size_t v = y * w + x;
+            b.add(v, v, 4.0 + 0.01 * double(v % 7));
+            if (x > 0) b.add(v, v - 1, -1.6);
+            if (x + 1 < w) b.add(v, v + 1, -0.4);
+            if (y > 0) b.add(v, v - w, -1.3);
+            if (y + 1 < h) b.add(v, v + w, -0.7);
+        }
+    return b.build();
+}
+
+TDynamicVector<double> make_rhs(size_t n)
+{
+    TDynamicVector<double> b(n);
+    for (size_t i = 0; i < n; ++i)
+        b[i] = 1.0 + double(i % 5);
+    return b;
+}
+
+double relative_residual(const TSparseMatrixCSR<double>& a, const TDynamicVector<double>& x, const TDynamicVector<double>& b)
+{
+    TDynamicVector<double> r = a * x;
+    double rr = 0, bb = 0;
+    for (size_t i = 0; i < b.size(); ++i) {
+        rr += (b[i] - r[i]) * (b[i] - r[i]);
+        bb += b[i] * b[i];
+    }
+    return std::sqrt(rr / bb);
+}
+}
+
+TEST(TKrylov, cg_solves_poisson_with_csr)
+{
+    const TSparseMatrixCSR<double> a = make_grid_laplacian(30, 30);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    TDynamicVector<double> x(a.rows());
+    TConjugateGradient<double> cg(a.rows(), 1e-10);
+
+    const TSolverResult<double> res = cg.solve(a, b, x);
+
+    EXPECT_TRUE(res.converged);
+    EXPECT_LT(res.residual, 1e-10);
+    EXPECT_LT(relative_residual(a, x, b), 1e-9);
+}
+
+TEST(TKrylov, preconditioners_reduce_cg_iterations)
+{
+    const TSparseMatrixCSR<double> a = make_grid_laplacian(40, 40);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    TConjugateGradient<double> cg(a.rows(), 1e-8);
+
+    TDynamicVector<double> x0(a.rows()), x1(a.rows());
+    const TSolverResult<double> plain = cg.solve(a, b, x0);
+    const TSolverResult<double> ic = cg.solve(a, b, x1, TIc0<double>(a));
+
+    ASSERT_TRUE(plain.converged);
+    ASSERT_TRUE(ic.converged);
+    EXPECT_LT(ic.iterations, plain.iterations);
+    EXPECT_LT(relative_residual(a, x1, b), 1e-7);
+}
+
+TEST(TKrylov, cg_accepts_dense_matrix_and_functor)
+{
+    const size_t n = 50;
+    TDynamicMatrix<double> d(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            d[i][j] = i == j ? 4.0 : (i + 1 == j || j + 1 == i ? -1.0 : 0.0);
+    //     
+    auto op = [n](const TDynamicVector<double>& x, TDynamicVector<double>& y) {
+        for (size_t i = 0; i < n; ++i)
+            y[i] = 4.0 * x[i] - (i > 0 ? x[i - 1] : 0.0) - (i + 1 < n ? x[i + 1] : 0.0);
+    };
+    const TDynamicVector<double> b = make_rhs(n);
+    TConjugateGradient<double> cg(n, 1e-12);
+
+    TDynamicVector<double> x0(n), x1(n);
+    const TSolverResult<double> r0 = cg.solve(d, b, x0);
+    const TSolverResult<double> r1 = cg.solve(op, b, x1);
+
+    ASSERT_TRUE(r0.converged);
+    ASSERT_TRUE(r1.converged);
+    EXPECT_EQ(r0.iterations, r1.iterations);
+    TDynamicVector<double> y = d * x1;
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_NEAR(b[i], y[i], 1e-9);
+}
+
+TEST(TKrylov, bicgstab_solves_nonsymmetric_system)
+{
+    const TSparseMatrixCSR<double> a = make_convection(30, 30);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    TBiCgStab<double> solver(a.rows(), 1e-10);
+
+    TDynamicVector<double> x0(a.rows()), x1(a.rows());
+    const TSolverResult<double> plain = solver.solve(a, b, x0);
+    const TSolverResult<double> ilu = solver.solve(a, b, x1, TIlu0<double>(a));
+
+    ASSERT_TRUE(plain.converged);
+    ASSERT_TRUE(ilu.converged);
+    EXPECT_LE(ilu.iterations, plain.iterations);
+    EXPECT_LT(relative_residual(a, x0, b), 1e-9);
+    EXPECT_LT(relative_residual(a, x1, b), 1e-9);
+}
+
+TEST(TKrylov, restarted_gmres_solves_nonsymmetric_system)
+{
+    const TSparseMatrixCSR<double> a = make_convection(30, 30);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    TGmres<double> gmres(a.rows(), 10, 1e-10, 2000);
+
+    TDynamicVector<double> x0(a.rows()), x1(a.rows());
+    const TSolverResult<double> plain = gmres.solve(a, b, x0);
+    const TSolverResult<double> jac = gmres.solve(a, b, x1, TJacobi<double>(a));
+
+    ASSERT_TRUE(plain.converged);
+    ASSERT_TRUE(jac.converged);
+    EXPECT_GT(plain.iterations, gmres.restart());
+    EXPECT_LT(relative_residual(a, x0, b), 1e-9);
+    EXPECT_LT(relative_residual(a, x1, b), 1e-9);
+}
+
+TEST(TKrylov, gmres_without_restart_is_exact_on_small_system)
+{
+    const TSparseMatrixCSR<double> a = make_convection(4, 4);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    TDynamicVector<double> x(a.rows());
+    TGmres<double> gmres(a.rows(), a.rows(), 1e-12);
+
+    const TSolverResult<double> res = gmres.solve(a, b, x);
+
+    ASSERT_TRUE(res.converged);
+    EXPECT_LE(res.iterations, a.rows());
+    EXPECT_LT(relative_residual(a, x, b), 1e-11);
+}
+
+TEST(TKrylov, stops_at_iteration_limit)
+{
+    const TSparseMatrixCSR<double> a = make_grid_laplacian(40, 40);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    TDynamicVector<double> x(a.rows());
+    TConjugateGradient<double> cg(a.rows(), 1e-12, 5);
+
+    const TSolverResult<double> res = cg.solve(a, b, x);
+
+    EXPECT_FALSE(res.converged);
+    EXPECT_EQ(5u, res.iterations);
+}
+
+TEST(TKrylov, zero_rhs_gives_zero_solution)
+{
+    const TSparseMatrixCSR<double> a = make_grid_laplacian(5, 5);
+    TDynamicVector<double> b(a.rows()), x = make_rhs(a.rows());
+    TBiCgStab<double> solver(a.rows());
+
+    const TSolverResult<double> res = solver.solve(a, b, x);
+
+    EXPECT_TRUE(res.converged);
+    EXPECT_EQ(0u, res.iterations);
+    EXPECT_EQ(b, x);
+}
+
+TEST(TKrylov, parallel_solve_converges)
+{
+    TThreadPool::set_threads(4);
+    const TSparseMatrixCSR<double> a = make_grid_laplacian(300, 300);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    TDynamicVector<double> x(a.rows());
+    TConjugateGradient<double> cg(a.rows(), 1e-8);
+
+    const TSolverResult<double> res = cg.solve(a, b, x, TJacobi<double>(a));
+    TThreadPool::set_threads(0);
+
+    ASSERT_TRUE(res.converged);
+    EXPECT_LT(relative_residual(a, x, b), 1e-7);
+}
+
+TEST(TKrylov, solvers_do_not_allocate_per_solve)
+{
+    //   ,  SpMV,    
+    //        
+    TThreadPool::set_threads(4);
+    const TSparseMatrixCSR<double> a = make_convection(150, 150);
+    const TSparseMatrixCSR<double> spd = make_grid_laplacian(150, 150);
+    const TDynamicVector<double> b = make_rhs(a.rows());
+    const TIlu0<double> ilu(a);
+    const TIc0<double> ic(spd);
+    TDynamicVector<double> x0(a.rows()), x1(a.rows()), x2(a.rows());
+    TConjugateGradient<double> cg(a.rows());
+    TBiCgStab<double> bicg(a.rows());
+    TGmres<double> gmres(a.rows(), 15);
+
+    const size_t before = allocation_count;
+    const bool ok = cg.solve(spd, b, x0, ic).converged && bicg.solve(a, b, x1, ilu).converged &&
+                    gmres.solve(a, b, x2, ilu).converged;
+    const size_t allocations = allocation_count - before;
+    TThreadPool::set_threads(0);
+
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(0u, allocations);
+}
+
+TEST(TKrylov, throws_on_size_mismatch)
+{
+    const TSparseMatrixCSR<double> a = make_grid_laplacian(3, 3);
+    TDynamicVector<double> b(a.rows()), x(a.rows() + 1);
+    TConjugateGradient<double> cg(a.rows());
+
+    ASSERT_ANY_THROW(cg.solve(a, b, x));
+    ASSERT_ANY_THROW(TGmres<double>(a.rows(), 0));
+    ASSERT_ANY_THROW(TBiCgStab<double>(a.rows(), -1.0));
+}
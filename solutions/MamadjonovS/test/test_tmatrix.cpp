@@ -1,4 +1,5 @@
 #include "tmatrix.h"
+#include "test_alloc.h"
 
 #include <gtest.h>
 
@@ -222,4 +223,349 @@ TEST(TDynamicMatrix, cant_subtract_matrixes_with_not_equal_size)
     ASSERT_ANY_THROW(m1 - m2);
 }
 
- 
\ No newline at end of file
+TEST(TDynamicMatrix, rows_are_stored_in_one_contiguous_aligned_buffer)
+{
+    TDynamicMatrix<double> m(5);
+    const double* r0 = m[0].data();
+    const double* r1 = m[1].data();
+
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(r0) % 64, 0u);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(r1) % 64, 0u);
+    ASSERT_EQ(m[4].data() - r0, 4 * (r1 - r0));
+}
+
+TEST(TDynamicMatrix, can_assign_row_from_row_and_vector)
+{
+    TDynamicMatrix<int> m(3);
+    TDynamicVector<int> v(3);
+    v[0] = 1; v[1] = 2; v[2] = 3;
+
+    m[0] = v;
+    m[2] = m[0];
+    m[0][0] = 10;
+
+    ASSERT_EQ(m[2][0], 1);
+    ASSERT_EQ(m[2][2], 3);
+    ASSERT_TRUE(TDynamicVector<int>(m[2]) == v);
+    ASSERT_ANY_THROW(m[1] = TDynamicVector<int>(4));
+}
+
+TEST(TDynamicMatrix, can_multiply_matrices_with_equal_size)
+{
+    TDynamicMatrix<int> m1(2);
+    m1[0][0] = 1; m1[0][1] = 2;
+    m1[1][0] = 3; m1[1][1] = 4;
+
+    TDynamicMatrix<int> m2(2);
+    m2[0][0] = 5; m2[0][1] = 6;
+    m2[1][0] = 7; m2[1][1] = 8;
+
+    TDynamicMatrix<int> result = m1 * m2;
+
+    ASSERT_EQ(result[0][0], 19);
+    ASSERT_EQ(result[0][1], 22);
+    ASSERT_EQ(result[1][0], 43);
+    ASSERT_EQ(result[1][1], 50);
+}
+
+TEST(TDynamicMatrix, blocked_multiplication_matches_naive_product)
+{
+    const size_t n = 2 * TGemm<double>::BLOCKED_THRESHOLD + 3;
+    TDynamicMatrix<double> a(n), b(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            a[i][j] = double((i * 7 + j * 3) % 11) - 5;
+            b[i][j] = double((i * 5 + j * 13) % 17) - 8;
+        }
+
+    TDynamicMatrix<double> c = a * b;
+
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            double expected = 0;
+            for (size_t k = 0; k < n; ++k)
+                expected += a[i][k] * b[k][j];
+            ASSERT_EQ(expected, c[i][j]);
+        }
+}
+
+template<typename T>
+static void expect_gemm_kernels_match_reference()
+{
+    const size_t n = 157;
+    TDynamicMatrix<T> a(n), b(n), expected(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            a[i][j] = T(int((i * 7 + j * 3) % 11) - 5);
+            b[i][j] = T(int((i * 5 + j * 13) % 17) - 8);
+        }
+    for (size_t i = 0; i < n; ++i)
+        for (size_t k = 0; k < n; ++k)
+            for (size_t j = 0; j < n; ++j)
+                expected[i][j] += a[i][k] * b[k][j];
+
+    for (int level = 0; level <= int(TCpu::detected()); ++level) {
+        TCpu::limit(TCpuLevel(level));
+        TDynamicMatrix<T> c = a * b;
+        EXPECT_TRUE(c == expected) << "kernel " << TGemm<T>::kernel().name;
+    }
+    TCpu::limit(TCpuLevel::AVX512);
+}
+
+TEST(TDynamicMatrix, every_available_gemm_kernel_matches_reference)
+{
+    expect_gemm_kernels_match_reference<double>();
+    expect_gemm_kernels_match_reference<float>();
+    expect_gemm_kernels_match_reference<int>();
+}
+
+TEST(TDynamicMatrix, chained_expression_is_evaluated_in_one_pass)
+{
+    TDynamicMatrix<int> a(3), b(3), c(3);
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j) {
+            a[i][j] = int(i + j);
+            b[i][j] = int(i * j);
+            c[i][j] = 1;
+        }
+
+    TDynamicMatrix<int> r(5);
+    r = a + b - c * 2;
+    TDynamicMatrix<int> h = hadamard(a, 3 * b);
+
+    ASSERT_EQ(3u, r.size());
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j) {
+            ASSERT_EQ(int(i + j + i * j) - 2, r[i][j]);
+            ASSERT_EQ(int((i + j) * 3 * i * j), h[i][j]);
+        }
+}
+
+TEST(TDynamicMatrix, can_compare_expression_with_matrix)
+{
+    TDynamicMatrix<int> m(3), z(3);
+    for (size_t i = 0; i < 3; ++i)
+        m[i][i] = int(i + 1);
+
+    EXPECT_TRUE((m + z) == m);
+    EXPECT_TRUE(m == (z + m));
+    EXPECT_TRUE((m + m) != m);
+    EXPECT_TRUE((m + m) == m * 2);
+}
+
+TEST(TDynamicMatrix, can_multiply_expression_by_matrix_and_vector)
+{
+    TDynamicMatrix<int> a(2), b(2);
+    a[0][0] = 1; a[0][1] = 2;
+    a[1][0] = 3; a[1][1] = 4;
+    b[0][0] = 1; b[1][1] = 1;
+    TDynamicVector<int> v(2);
+    v[0] = 1; v[1] = 1;
+
+    TDynamicMatrix<int> p = (a + b) * a;
+    TDynamicVector<int> r = (a - b) * v;
+    TDynamicMatrix<int> q = a * (b * 2);
+
+    ASSERT_EQ(2 * 1 + 2 * 3, p[0][0]);
+    ASSERT_EQ(3 * 2 + 5 * 4, p[1][1]);
+    ASSERT_EQ(2, r[0]);
+    ASSERT_EQ(6, r[1]);
+    ASSERT_EQ(4, q[0][1]);
+    ASSERT_EQ(-8, (v + v) * (v - 3));
+}
+
+TEST(TDynamicMatrix, chain_of_sums_allocates_only_the_result)
+{
+    TDynamicMatrix<int> a(4), b(4), c(4), d(4);
+    a[1][2] = 1; b[1][2] = 2; c[1][2] = 3; d[1][2] = 4;
+
+    const size_t before = allocation_count;
+    TDynamicMatrix<int> r = a + b + c + d;
+
+    ASSERT_EQ(1u, allocation_count - before);
+    ASSERT_EQ(10, r[1][2]);
+}
+
+TEST(TDynamicMatrix, operations_on_expiring_matrix_reuse_its_buffer)
+{
+    TDynamicMatrix<int> a(4), b(4), c(4);
+    for (size_t i = 0; i < 4; ++i) {
+        a[i][i] = 2;
+        b[i][i] = 3;
+        c[i][i] = 1;
+    }
+
+    const size_t before = allocation_count;
+    TDynamicMatrix<int> r = a * b + c - b * 2 + c;
+    TDynamicMatrix<int> q = c - TDynamicMatrix<int>(a * 3);
+
+    ASSERT_EQ(2u, allocation_count - before);
+    ASSERT_EQ(2 * 3 + 1 - 3 * 2 + 1, r[3][3]);
+    ASSERT_EQ(0, r[0][1]);
+    ASSERT_EQ(1 - 6, q[2][2]);
+}
+
+TEST(TDynamicMatrix, compound_assignment_does_not_allocate)
+{
+    TDynamicMatrix<int> acc(3), delta(3), id(3);
+    for (size_t i = 0; i < 3; ++i) {
+        id[i][i] = 1;
+        for (size_t j = 0; j < 3; ++j)
+            delta[i][j] = int(i * 3 + j);
+    }
+    acc *= id;
+
+    const size_t before = allocation_count;
+    for (int it = 0; it < 10; ++it) {
+        acc += delta;
+        acc -= id * 2;
+        acc *= 2;
+        acc *= id;
+    }
+
+    ASSERT_EQ(0u, allocation_count - before);
+    ASSERT_EQ(2046 * int(1 * 3 + 2), acc[1][2]);
+    ASSERT_EQ(2046 * (int(1 * 3 + 1) - 2), acc[1][1]);
+}
+
+TEST(TDynamicMatrix, product_assignment_keeps_scratch_only_for_small_matrices)
+{
+    TDynamicMatrix<double> small(4), big(600), id(600);
+    for (size_t i = 0; i < 600; ++i) {
+        id[i][i] = 1.0;
+        big[i][(i * 7) % 600] = double(i);
+    }
+    for (size_t i = 0; i < 4; ++i)
+        small[i][i] = 2.0;
+    TDynamicMatrix<double>::release_scratch();
+
+    size_t before = allocation_count;
+    small *= small;
+    small *= small;
+    EXPECT_EQ(1u, allocation_count - before);
+
+    before = allocation_count;
+    big *= id;
+    big *= id;
+    EXPECT_EQ(2u, allocation_count - before);
+    EXPECT_EQ(16.0, small[3][3]);
+    EXPECT_EQ(5.0, big[5][35]);
+    TDynamicMatrix<double>::release_scratch();
+}
+
+TEST(TDynamicMatrix, gemm_applies_alpha_beta_epilogue)
+{
+    for (int level = 0; level <= int(TCpu::detected()); ++level)
+    for (size_t n : { 5, 70, 150 }) {
+        TCpu::limit(TCpuLevel(level));
+        TDynamicMatrix<double> a(n), b(n), c(n);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) {
+                a[i][j] = double((i + 2 * j) % 7) - 3;
+                b[i][j] = double((3 * i + j) % 5) - 2;
+                c[i][j] = double((i * j) % 3);
+            }
+        TDynamicMatrix<double> expected = a * b * 2.0 + c * 0.5;
+
+        gemm(2.0, a, b, 0.5, c);
+        EXPECT_EQ(expected, c);
+
+        gemm(1.0, a, b, 0.0, c);
+        EXPECT_EQ(a * b, c);
+    }
+    TCpu::limit(TCpuLevel::AVX512);
+}
+
+TEST(TDynamicMatrix, gemm_and_gemv_write_into_preallocated_output)
+{
+    const size_t n = 80;
+    TDynamicMatrix<double> a(n), b(n), c(n);
+    TDynamicVector<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = double(i % 4);
+        y[i] = 1.0;
+        for (size_t j = 0; j < n; ++j) {
+            a[i][j] = double((i + j) % 3);
+            b[i][j] = double(i == j);
+        }
+    }
+    gemm(1.0, a, b, 0.0, c);
+
+    const size_t before = allocation_count;
+    gemm(1.0, a, b, 1.0, c);
+    gemv(3.0, a, x, -1.0, y);
+    ASSERT_EQ(0u, allocation_count - before);
+
+    EXPECT_EQ(TDynamicMatrix<double>(a * 2.0), c);
+    TDynamicVector<double> ax = a * x;
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_EQ(3.0 * ax[i] - 1.0, y[i]);
+}
+
+TEST(TDynamicMatrix, gemm_throws_on_size_mismatch_or_aliasing)
+{
+    TDynamicMatrix<int> a(3), b(4);
+    TDynamicVector<int> x(3), y(4);
+    ASSERT_ANY_THROW(gemm(1, a, b, 0, a));
+    ASSERT_ANY_THROW(gemm(1, a, a, 0, a));
+    ASSERT_ANY_THROW(gemv(1, a, x, 0, y));
+    ASSERT_ANY_THROW(gemv(1, a, x, 0, x));
+}
+
+TEST(TThreadPool, parallel_for_runs_every_task_once_and_rethrows)
+{
+    TThreadPool::set_threads(4);
+    vector<int> hits(1000);
+    TThreadPool::parallel_for(hits.size(), [&](size_t t) {
+        //      
+        TThreadPool::parallel_for(2, [&](size_t) { ++hits[t]; });
+    });
+    EXPECT_EQ(vector<int>(1000, 2), hits);
+
+    EXPECT_THROW(TThreadPool::parallel_for(100, [](size_t t) {
+        if (t == 57)
+            throw out_of_range("task failed");
+    }), out_of_range);
+
+    {
+        TThreadScope one(1);
+        EXPECT_EQ(1u, TThreadPool::threads());
+    }
+    EXPECT_EQ(4u, TThreadPool::threads());
+    TThreadPool::set_threads(0);
+}
+
+TEST(TDynamicMatrix, parallel_operations_match_single_thread)
+{
+    const size_t n = 300;
+    TDynamicMatrix<double> a(n), b(n), c(n);
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = double(i % 5) - 2;
+        for (size_t j = 0; j < n; ++j) {
+            a[i][j] = double((i * 7 + j) % 11) - 5;
+            b[i][j] = double((i + j * 3) % 13) - 6;
+            c[i][j] = double((i + j) % 3);
+        }
+    }
+
+    TDynamicMatrix<double> prod(n), sum(n), diff(n), acc(c);
+    TDynamicVector<double> mv(n);
+    {
+        TThreadScope one(1);
+        prod = a * b;
+        sum = a + b * 2.0;
+        diff = a - b;
+        mv = a * x;
+        gemm(2.0, a, b, -1.0, acc);
+    }
+
+    TThreadPool::set_threads(4);
+    EXPECT_EQ(prod, a * b);
+    EXPECT_EQ(sum, TDynamicMatrix<double>(a + b * 2.0));
+    EXPECT_EQ(diff, TDynamicMatrix<double>(a - b));
+    EXPECT_EQ(mv, a * x);
+    gemm(2.0, a, b, -1.0, c);
+    EXPECT_EQ(acc, c);
+    TThreadPool::set_threads(0);
+}
@@ -0,0 +1,164 @@
+#include "tmtx.h"
+
+#include <sstream>
+
+#include <gtest.h>
+
+TEST(TMatrixMarket, reads_header)
+{
+    istringstream in("%%MatrixMarket matrix coordinate Pattern symmetric\n% comment\n\n 4 4 3\n");
+    TMtxHeader h = TMatrixMarket::read_header(in);
+
+    EXPECT_EQ(TMtxHeader::Format::Coordinate, h.format);
+    EXPECT_EQ(TMtxHeader::Field::Pattern, h.field);
+    EXPECT_EQ(TMtxHeader::Symmetry::Symmetric, h.symmetry);
+    EXPECT_EQ(4u, h.rows);
+    EXPECT_EQ(3u, h.entries);
+}
+
+TEST(TMatrixMarket, rejects_unsupported_files)
+{
+    istringstream complex_field("%%MatrixMarket matrix coordinate complex general\n2 2 0\n");
+    istringstream not_mtx("2 2 0\n");
+    istringstream rectangular_symmetric("%%MatrixMarket matrix coordinate real symmetric\n2 3 0\n");
+
+    ASSERT_ANY_THROW(TMatrixMarket::read_header(complex_field));
+    ASSERT_ANY_THROW(TMatrixMarket::read_header(not_mtx));
+    ASSERT_ANY_THROW(TMatrixMarket::read_header(rectangular_symmetric));
+}
+
+TEST(TMatrixMarket, reads_coordinate_general)
+{
+    istringstream in("%%MatrixMarket matrix coordinate real general\n"
+                     "2 3 3\n"
+                     "1 3 2.5\n"
+                     "% comment between entries\n"
+                     "2 2 -1e2\n"
+                     "1 1 1\n");
+
+    EXPECT_EQ(TSparseMatrixCSR<double>(2, 3, { 0, 2, 3 }, { 0, 2, 1 }, { 1, 2.5, -100 }),
+              TMatrixMarket::read_sparse<double>(in));
+}
+
+TEST(TMatrixMarket, mirrors_symmetric_and_skew_symmetric_entries)
+{
+    istringstream sym("%%MatrixMarket matrix coordinate integer symmetric\n3 3 3\n1 1 4\n3 1 2\n3 2 7\n");
+    istringstream skew("%%MatrixMarket matrix coordinate integer skew-symmetric\n2 2 1\n2 1 5\n");
+    istringstream pattern("%%MatrixMarket matrix coordinate pattern symmetric\n2 2 1\n2 1\n");
+
+    TDynamicMatrix<int> s = TMatrixMarket::read_dense<int>(sym);
+    EXPECT_EQ(4, s[0][0]);
+    EXPECT_EQ(2, s[0][2]);
+    EXPECT_EQ(2, s[2][0]);
+    EXPECT_EQ(7, s[1][2]);
+    EXPECT_EQ(TSparseMatrixCSR<int>(2, 2, { 0, 1, 2 }, { 1, 0 }, { -5, 5 }), TMatrixMarket::read_sparse<int>(skew));
+    EXPECT_EQ(TSparseMatrixCSR<int>(2, 2, { 0, 1, 2 }, { 1, 0 }, { 1, 1 }), TMatrixMarket::read_sparse<int>(pattern));
+}
+
+TEST(TMatrixMarket, reads_array_formats)
+{
+    istringstream general("%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n");
+    istringstream sym("%%MatrixMarket matrix array real symmetric\n3 3\n1\n2\n3\n4\n5\n6\n");
+
+    TDynamicMatrix<double> g = TMatrixMarket::read_dense<double>(general);
+    EXPECT_EQ(2.0, g[1][0]);
+    EXPECT_EQ(3.0, g[0][1]);
+    TDynamicMatrix<double> s = TMatrixMarket::read_dense<double>(sym);
+    EXPECT_EQ(3.0, s[2][0]);
+    EXPECT_EQ(3.0, s[0][2]);
+    EXPECT_EQ(4.0, s[1][1]);
+    EXPECT_EQ(5.0, s[1][2]);
+    EXPECT_EQ(6.0, s[2][2]);
+}
+
+TEST(TMatrixMarket, array_zeros_are_not_stored_in_sparse)
+{
+    istringstream general("%%MatrixMarket matrix array real general\n2 2\n1\n0\n0\n4\n");
+    istringstream sym("%%MatrixMarket matrix array integer symmetric\n2 2\n0\n3\n0\n");
+
+    EXPECT_EQ(TSparseMatrixCSR<double>(2, 2, { 0, 1, 2 }, { 0, 1 }, { 1, 4 }), TMatrixMarket::read_sparse<double>(general));
+    EXPECT_EQ(TSparseMatrixCSR<int>(2, 2, { 0, 1, 2 }, { 1, 0 }, { 3, 3 }), TMatrixMarket::read_sparse<int>(sym));
+}
+
+TEST(TMatrixMarket, dense_read_rejects_duplicate_entries)
+{
+    istringstream repeated("%%MatrixMarket matrix coordinate real general\n2 2 3\n1 1 1\n2 2 2\n1 1 3\n");
+    istringstream mirrored("%%MatrixMarket matrix coordinate real symmetric\n2 2 2\n2 1 1\n1 2 1\n");
+    istringstream summed("%%MatrixMarket matrix coordinate real general\n2 2 3\n1 1 1\n2 2 2\n1 1 3\n");
+
+    ASSERT_ANY_THROW(TMatrixMarket::read_dense<double>(repeated));
+    ASSERT_ANY_THROW(TMatrixMarket::read_dense<double>(mirrored));
+    EXPECT_EQ(4.0, TMatrixMarket::read_sparse<double>(summed).get(0, 0));
+}
+
+TEST(TMatrixMarket, dense_read_rejects_duplicates_across_threads)
+{
+    //         
+    const size_t n = 300;
+    stringstream in;
+    in << "%%MatrixMarket matrix coordinate real general\n" << n << ' ' << n << ' ' << n * n + 1 << '\n';
+    for (size_t j = 1; j <= n; ++j)
+        for (size_t i = 1; i <= n; ++i)
+            in << i << ' ' << j << " 1.5\n";
+    in << "1 1 2\n";
+
+    TThreadPool::set_threads(4);
+    ASSERT_ANY_THROW(TMatrixMarket::read_dense<double>(in));
+    TThreadPool::set_threads(0);
+}
+
+TEST(TMatrixMarket, throws_on_malformed_body)
+{
+    istringstream short_body("%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n");
+    istringstream bad_number("%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 x\n");
+    istringstream bad_index("%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n");
+    istringstream long_array("%%MatrixMarket matrix array real general\n1 1\n1\n2\n");
+
+    ASSERT_ANY_THROW(TMatrixMarket::read_sparse<double>(short_body));
+    ASSERT_ANY_THROW(TMatrixMarket::read_sparse<double>(bad_number));
+    ASSERT_ANY_THROW(TMatrixMarket::read_sparse<double>(bad_index));
+    ASSERT_ANY_THROW(TMatrixMarket::read_dense<double>(long_array));
+}
+
+TEST(TMatrixMarket, round_trips_dense_and_sparse)
+{
+    TDynamicMatrix<double> d(5);
+    for (size_t i = 0; i < 5; ++i)
+        for (size_t j = 0; j < 5; ++j)
+            d[i][j] = (i == j || i + 1 == j) ? 0.1 * double(i * 5 + j) + 1e-17 : 0.0;
+    TSparseMatrixCSR<double> s(d);
+
+    stringstream dense_io, sparse_io;
+    TMatrixMarket::write(dense_io, d);
+    TMatrixMarket::write(sparse_io, s);
+    EXPECT_EQ(d, TMatrixMarket::read_dense<double>(dense_io));
+    EXPECT_EQ(s, TMatrixMarket::read_sparse<double>(sparse_io));
+}
+
+TEST(TMatrixMarket, writes_lower_triangle_of_symmetric_matrix)
+{
+    TSparseMatrixCSR<int> s(2, 2, { 0, 2, 4 }, { 0, 1, 0, 1 }, { 1, 2, 2, 3 });
+    stringstream io;
+    TMatrixMarket::write(io, s, true);
+
+    EXPECT_EQ("%%MatrixMarket matrix coordinate integer symmetric\n2 2 3\n1 1 1\n2 1 2\n2 2 3\n", io.str());
+    EXPECT_EQ(s, TMatrixMarket::read_sparse<int>(io));
+}
+
+TEST(TMatrixMarket, reads_file_larger_than_one_chunk_in_parallel)
+{
+    const size_t n = 100000, per_row = 8;
+    TSparseBuilder<double> b(n, n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t k = 0; k < per_row; ++k)
+            b.add(i, (i * 131 + k * 6007) % n, double(i % 1000) / 8 + double(k));
+    TSparseMatrixCSR<double> s = b.build();
+    stringstream io;
+    TMatrixMarket::write(io, s);
+    ASSERT_GT(io.str().size(), size_t(1) << 23);
+
+    TThreadPool::set_threads(4);
+    TSparseMatrixCSR<double> r = TMatrixMarket::read_sparse<double>(io);
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(s, r);
+}
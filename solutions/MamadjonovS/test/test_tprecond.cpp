@@ -0,0 +1,161 @@
+#include "tprecond.h"
+#include "tsparsebuilder.h"
+#include "test_alloc.h"
+#include "test_grid.h"
+
+#include <gtest.h>
+
+namespace
+{
+//   :  ILU(0) -  LU
+TSparseMatrixCSR<double> make_tridiagonal(size_t n)
+{
+    TSparseBuilder<double> b(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        b.add(i, i, 3.0 + double(i % 3));
+        if (i > 0) b.add(i, i - 1, -1.0);
+        if (i + 1 < n) b.add(i, i + 1, -0.5 - double(i % 2));
+    }
+    return b.build();
+}
+
+TDynamicVector<double> make_x(size_t n)
+{
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = double(i % 7) - 3;
+    return x;
+}
+
+double max_error(const TDynamicVector<double>& a, const TDynamicVector<double>& b)
+{
+    double e = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        e = std::max(e, std::abs(a[i] - b[i]));
+    return e;
+}
+
+// (L U)[i][j]         L
+double lu_entry(const TSparseMatrixCSR<double>& f, size_t i, size_t j)
+{
+    double s = 0;
+    for (size_t k = 0; k <= std::min(i, j); ++k)
+        s += (k == i ? 1.0 : f.get(i, k)) * f.get(k, j);
+    return s;
+}
+}
+
+TEST(TIlu0, is_exact_for_tridiagonal_matrix)
+{
+    TSparseMatrixCSR<double> a = make_tridiagonal(500);
+    TIlu0<double> m(a);
+    TDynamicVector<double> x = make_x(500), z(500);
+
+    EXPECT_EQ(a.nnz(), m.factors().nnz());
+    m.apply(a * x, z);
+    EXPECT_LT(max_error(x, z), 1e-12);
+}
+
+TEST(TIlu0, reproduces_matrix_on_its_pattern)
+{
+    TSparseMatrixCSR<double> a = make_grid_laplacian(6, 5);
+    TIlu0<double> m(a);
+
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t k = a.row_ptr()[i]; k < a.row_ptr()[i + 1]; ++k)
+            EXPECT_NEAR(a.values()[k], lu_entry(m.factors(), i, a.col_idx()[k]), 1e-12);
+}
+
+TEST(TIlu0, throws_on_missing_diagonal)
+{
+    TSparseMatrixCSR<double> a(2, 2, { 0, 1, 2 }, { 1, 0 }, { 1, 1 });
+
+    ASSERT_ANY_THROW(TIlu0<double> m(a));
+}
+
+TEST(TIlut, without_dropping_is_complete_lu)
+{
+    TSparseMatrixCSR<double> a = make_grid_laplacian(8, 6);
+    TIlut<double> m(a, 0.0, a.rows());
+    TDynamicVector<double> x = make_x(a.rows()), z(a.rows());
+
+    EXPECT_GT(m.factors().nnz(), a.nnz());
+    m.apply(a * x, z);
+    EXPECT_LT(max_error(x, z), 1e-10);
+}
+
+TEST(TIlut, threshold_limits_fill)
+{
+    TSparseMatrixCSR<double> a = make_grid_laplacian(20, 20);
+    TIlut<double> loose(a, 1e-2, 5), tight(a, 1e-6, 50);
+    TDynamicVector<double> x = make_x(a.rows()), z(a.rows());
+
+    EXPECT_LT(loose.factors().nnz(), tight.factors().nnz());
+    for (size_t i = 0; i < a.rows(); ++i)
+        EXPECT_LE(loose.factors().row_ptr()[i + 1] - loose.factors().row_ptr()[i], 11u);
+    tight.apply(a * x, z);
+    EXPECT_LT(max_error(x, z), 1e-3);
+}
+
+TEST(TIc0, is_exact_for_tridiagonal_spd_matrix)
+{
+    TSparseBuilder<double> b(300, 300);
+    for (size_t i = 0; i < 300; ++i) {
+        b.add(i, i, 2.5);
+        if (i > 0) {
+            b.add(i, i - 1, -1.0);
+            b.add(i - 1, i, -1.0);
+        }
+    }
+    TSparseMatrixCSR<double> a = b.build();
+    TIc0<double> m(a);
+    TDynamicVector<double> x = make_x(300), z(300);
+
+    m.apply(a * x, z);
+    EXPECT_LT(max_error(x, z), 1e-12);
+}
+
+TEST(TIc0, throws_on_indefinite_matrix)
+{
+    TSparseMatrixCSR<double> a(2, 2, { 0, 2, 4 }, { 0, 1, 0, 1 }, { 1, 2, 2, 1 });
+
+    ASSERT_ANY_THROW(TIc0<double> m(a));
+}
+
+TEST(TIncompleteLU, apply_does_not_allocate)
+{
+    TSparseMatrixCSR<double> a = make_grid_laplacian(30, 30, 0.1);
+    TIlu0<double> ilu(a);
+    TIlut<double> ilut(a, 1e-3, 10);
+    TIc0<double> ic(a);
+    TDynamicVector<double> r = make_x(a.rows()), z(a.rows());
+
+    TThreadScope serial(1);
+    const size_t before = allocation_count;
+    ilu.apply(r, z);
+    ilut.apply(r, z);
+    ic.apply(r, z);
+    z = r;
+    ic.apply(z, z);
+    ASSERT_EQ(0u, allocation_count - before);
+}
+
+TEST(TIncompleteLU, parallel_apply_matches_serial)
+{
+    TSparseMatrixCSR<double> a = make_grid_laplacian(300, 200);
+    TIlu0<double> ilu(a);
+    TIc0<double> ic(a);
+    TDynamicVector<double> r = make_x(a.rows()), serial(a.rows()), parallel(a.rows());
+
+    ilu.apply(r, serial);
+    TThreadPool::set_threads(4);
+    ilu.apply(r, parallel);
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(serial, parallel);
+
+    ic.apply(r, serial);
+    TThreadPool::set_threads(4);
+    ic.apply(r, parallel);
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(serial, parallel);
+}
@@ -0,0 +1,71 @@
+#include "treorder.h"
+#include "test_grid.h"
+
+#include <gtest.h>
+
+TEST(TPermutation, validates_permutation)
+{
+    ASSERT_NO_THROW(TPermutation(vector<size_t>({ 2, 0, 1 })));
+    ASSERT_ANY_THROW(TPermutation(vector<size_t>({ 2, 0, 2 })));
+    ASSERT_ANY_THROW(TPermutation(vector<size_t>({ 3, 0, 1 })));
+}
+
+TEST(TPermutation, applies_to_vector_and_back)
+{
+    TPermutation p(vector<size_t>({ 2, 0, 3, 1 }));
+    TDynamicVector<int> x(4);
+    for (size_t i = 0; i < 4; ++i)
+        x[i] = int(i * 10);
+
+    TDynamicVector<int> y = p.apply(x);
+    EXPECT_EQ(20, y[0]);
+    EXPECT_EQ(0, y[1]);
+    EXPECT_EQ(3u, p.position(1));
+    EXPECT_EQ(x, p.apply_inverse(y));
+    EXPECT_EQ(x, p.inverse().apply(y));
+    EXPECT_EQ(p, p.inverse().inverse());
+}
+
+TEST(TPermutation, symmetric_application_commutes_with_spmv)
+{
+    TSparseMatrixCSR<double> a = make_grid_laplacian(30, 20, 0.0, 7919);
+    vector<size_t> order(a.rows());
+    for (size_t k = 0; k < order.size(); ++k)
+        order[k] = (k * 13) % order.size();
+    TPermutation p(order);
+    TDynamicVector<double> x(a.rows());
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = double(i % 9);
+
+    TSparseMatrixCSR<double> b = p.apply(a);
+    EXPECT_EQ(a.nnz(), b.nnz());
+    EXPECT_EQ(a.get(order[3], order[5]), b.get(3, 5));
+    EXPECT_EQ(p.apply(a * x), b * p.apply(x));
+    EXPECT_EQ(a, p.inverse().apply(b));
+}
+
+TEST(TPermutation, rcm_reduces_grid_bandwidth)
+{
+    TSparseMatrixCSR<double> a = make_grid_laplacian(40, 25, 0.0, 7919);
+    TPermutation p = reverse_cuthill_mckee(a);
+    TSparseMatrixCSR<double> b = p.apply(a);
+
+    EXPECT_EQ(a.rows(), p.size());
+    EXPECT_GT(bandwidth(a), 500u);
+    EXPECT_LE(bandwidth(b), 30u);
+}
+
+TEST(TPermutation, rcm_handles_several_components)
+{
+    //   0-2-4  1-3    5
+    TSparseBuilder<double> b(6, 6);
+    for (auto e : { pair<size_t, size_t>(0, 2), { 2, 4 }, { 1, 3 } }) {
+        b.add(e.first, e.second, 1.0);
+        b.add(e.second, e.first, 1.0);
+    }
+    TSparseMatrixCSR<double> a = b.build();
+    TPermutation p = reverse_cuthill_mckee(a);
+
+    EXPECT_EQ(6u, p.size());
+    EXPECT_EQ(1u, bandwidth(p.apply(a)));
+}
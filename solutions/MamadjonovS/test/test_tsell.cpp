@@ -0,0 +1,124 @@
+#include "tsell.h"
+#include "tsparsebuilder.h"
+
+#include <gtest.h>
+
+#include <limits>
+
+namespace
+{
+//     n / (i + 1):     
+//  ,    
+template<typename T>
+TSparseMatrixCSR<T> make_irregular(size_t n)
+{
+    TSparseBuilder<T> b(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        const size_t row = (i * 7919) % n, len = std::min<size_t>(n, n / (i + 1) + i % 3);
+        for (size_t k = 0; k < len; ++k)
+            b.add(row, (row * 31 + k * 97) % n, T(int((row + k) % 7) - 3));
+    }
+    return b.build();
+}
+
+template<typename T>
+TDynamicVector<T> make_x(size_t n)
+{
+    TDynamicVector<T> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = T(int(i % 5) - 2);
+    return x;
+}
+}
+
+TEST(TSparseMatrixSELL, round_trips_through_csr)
+{
+    TSparseMatrixCSR<double> a = make_irregular<double>(301);
+    TSparseMatrixSELL<double> s(a);
+
+    EXPECT_EQ(a.nnz(), s.nnz());
+    EXPECT_EQ(0u, s.stored() % s.chunk_height());
+    EXPECT_EQ(a, s.to_csr());
+    EXPECT_EQ(a, (TSparseMatrixSELL<double, 4>(a, 1).to_csr()));
+}
+
+TEST(TSparseMatrixSELL, sorting_window_reduces_padding)
+{
+    TSparseMatrixCSR<double> a = make_irregular<double>(1000);
+
+    EXPECT_LT(TSparseMatrixSELL<double>(a, 1000).stored(), TSparseMatrixSELL<double>(a, 1).stored());
+}
+
+TEST(TSparseMatrixSELL, spmv_matches_csr_at_every_cpu_level)
+{
+    const size_t n = 3000;
+    TSparseMatrixCSR<double> ad = make_irregular<double>(n);
+    TSparseMatrixCSR<float> af = make_irregular<float>(n);
+    TSparseMatrixCSR<int> ai = make_irregular<int>(n);
+    TDynamicVector<double> xd = make_x<double>(n);
+    TDynamicVector<float> xf = make_x<float>(n);
+    TDynamicVector<int> xi = make_x<int>(n);
+
+    for (int level = 0; level <= int(TCpu::detected()); ++level) {
+        TCpu::limit(TCpuLevel(level));
+        EXPECT_EQ(ad * xd, TSparseMatrixSELL<double>(ad) * xd);
+        EXPECT_EQ(ad * xd, (TSparseMatrixSELL<double, 4>(ad) * xd));
+        EXPECT_EQ(af * xf, TSparseMatrixSELL<float>(af) * xf);
+        EXPECT_EQ(af * xf, (TSparseMatrixSELL<float, 16>(af) * xf));
+        EXPECT_EQ(ai * xi, TSparseMatrixSELL<int>(ai) * xi);
+        EXPECT_EQ(ai * xi, (TSparseMatrixSELL<int, 3>(ai) * xi));
+    }
+    TCpu::limit(TCpuLevel::AVX512);
+}
+
+TEST(TSparseMatrixSELL, spmv_matches_csr_on_many_threads)
+{
+    const size_t n = 20000;
+    TSparseMatrixCSR<double> a = make_irregular<double>(n);
+    TSparseMatrixSELL<double> s(a);
+    TDynamicVector<double> x = make_x<double>(n);
+
+    TThreadPool::set_threads(4);
+    TDynamicVector<double> y = s * x;
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(a * x, y);
+}
+
+TEST(TSparseMatrixSELL, padding_does_not_read_non_finite_x)
+{
+    //         ; x[0]  ,
+    //   0      ,   0 * inf
+    //    
+    const size_t n = 3000;
+    TSparseBuilder<double> bd(n, n);
+    TSparseBuilder<float> bf(n, n);
+    for (size_t i = 0; i < n; ++i)
+        if (i % 3 != 0)
+            for (size_t k = 0; k <= i % 11; ++k) {
+                bd.add(i, 1 + (i + k * 13) % (n - 1), double(int(k % 5) - 2));
+                bf.add(i, 1 + (i + k * 13) % (n - 1), float(int(k % 5) - 2));
+            }
+    TSparseMatrixCSR<double> ad = bd.build();
+    TSparseMatrixCSR<float> af = bf.build();
+    TDynamicVector<double> xd = make_x<double>(n);
+    TDynamicVector<float> xf = make_x<float>(n);
+    xd[0] = std::numeric_limits<double>::infinity();
+    xf[0] = std::numeric_limits<float>::quiet_NaN();
+
+    for (int level = 0; level <= int(TCpu::detected()); ++level) {
+        TCpu::limit(TCpuLevel(level));
+        EXPECT_EQ(ad * xd, (TSparseMatrixSELL<double>(ad, 1) * xd));
+        EXPECT_EQ(ad * xd, (TSparseMatrixSELL<double, 4>(ad, 1) * xd));
+        EXPECT_EQ(af * xf, (TSparseMatrixSELL<float>(af, 1) * xf));
+        EXPECT_EQ(af * xf, (TSparseMatrixSELL<float, 16>(af, 1) * xf));
+    }
+    TCpu::limit(TCpuLevel::AVX512);
+}
+
+TEST(TSparseMatrixSELL, throws_on_wrong_vector_size)
+{
+    TSparseMatrixSELL<double> s(make_irregular<double>(10));
+    TDynamicVector<double> x(9), y(10);
+
+    ASSERT_ANY_THROW(s.multiply(x, y));
+}
@@ -0,0 +1,278 @@
+#include "tsparse.h"
+#include "tsparsebuilder.h"
+
+#include <gtest.h>
+
+namespace
+{
+//  3% ,      
+TDynamicMatrix<double> make_sparse_dense(size_t n, unsigned seed)
+{
+    TDynamicMatrix<double> m(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            const unsigned h = unsigned(i * 2654435761u) ^ unsigned(j * 40503u + seed);
+            if (h % 97 < 3 && i % 11 != 5)
+                m[i][j] = double(int(h % 13) - 6);
+        }
+    return m;
+}
+}
+
+TEST(TSparseMatrixCSR, can_create_empty_matrix)
+{
+    TSparseMatrixCSR<double> m(3, 5);
+
+    EXPECT_EQ(3u, m.rows());
+    EXPECT_EQ(5u, m.cols());
+    EXPECT_EQ(0u, m.nnz());
+    ASSERT_ANY_THROW(TSparseMatrixCSR<double>(0, 5));
+}
+
+TEST(TSparseMatrixCSR, validates_raw_arrays)
+{
+    ASSERT_NO_THROW(TSparseMatrixCSR<int>(2, 3, { 0, 1, 3 }, { 2, 0, 1 }, { 1, 2, 3 }));
+    ASSERT_ANY_THROW(TSparseMatrixCSR<int>(2, 3, { 0, 1, 3 }, { 2, 1, 0 }, { 1, 2, 3 }));
+    ASSERT_ANY_THROW(TSparseMatrixCSR<int>(2, 3, { 0, 1, 3 }, { 2, 0, 3 }, { 1, 2, 3 }));
+    ASSERT_ANY_THROW(TSparseMatrixCSR<int>(2, 3, { 0, 1 }, { 2 }, { 1 }));
+}
+
+TEST(TSparseMatrixCSR, set_values_keeps_structure)
+{
+    TSparseMatrixCSR<int> a(2, 3, { 0, 1, 3 }, { 2, 0, 1 }, { 1, 2, 3 });
+    a.set_values({ 4, 5, 6 });
+
+    EXPECT_EQ(TSparseMatrixCSR<int>(2, 3, { 0, 1, 3 }, { 2, 0, 1 }, { 4, 5, 6 }), a);
+    ASSERT_ANY_THROW(a.set_values({ 1, 2 }));
+}
+
+TEST(TSparseMatrixCSR, memory_scales_with_nonzeros)
+{
+    TDynamicMatrix<double> d = make_sparse_dense(200, 1);
+    TSparseMatrixCSR<double> s(d);
+
+    size_t nonzeros = 0;
+    for (size_t i = 0; i < 200; ++i)
+        for (size_t j = 0; j < 200; ++j)
+            nonzeros += d[i][j] != 0;
+    EXPECT_EQ(nonzeros, s.nnz());
+    EXPECT_EQ(d, s.to_dense());
+    EXPECT_EQ(d[3][7], s.get(3, 7));
+}
+
+TEST(TSparseMatrixCSR, spmv_matches_dense_on_any_thread_count)
+{
+    const size_t n = 2000;
+    TDynamicMatrix<double> d = make_sparse_dense(n, 2);
+    TSparseMatrixCSR<double> s(d);
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = double(i % 9) - 4;
+    const TDynamicVector<double> expected = d * x;
+
+    EXPECT_EQ(expected, s * x);
+    TThreadPool::set_threads(4);
+    EXPECT_EQ(expected, s * x);
+    TThreadPool::set_threads(0);
+    ASSERT_ANY_THROW(s * TDynamicVector<double>(n + 1));
+}
+
+TEST(TSparseMatrixCSR, partition_balances_nonzeros)
+{
+    //      
+    vector<size_t> row_ptr = { 0, 1000 };
+    for (size_t i = 0; i < 1000; ++i)
+        row_ptr.push_back(row_ptr.back() + 1);
+
+    vector<size_t> bounds = csr_partition(row_ptr, 2);
+    ASSERT_EQ(3u, bounds.size());
+    EXPECT_EQ(1u, bounds[1]);
+    EXPECT_EQ(1001u, bounds[2]);
+}
+
+TEST(TSparseMatrixCSR, sparse_addition_and_subtraction_match_dense)
+{
+    const size_t n = 300;
+    TDynamicMatrix<double> a = make_sparse_dense(n, 3), b = make_sparse_dense(n, 4);
+    TSparseMatrixCSR<double> sa(a), sb(b);
+
+    EXPECT_EQ(TDynamicMatrix<double>(a + b), (sa + sb).to_dense());
+    EXPECT_EQ(TDynamicMatrix<double>(a - b), (sa - sb).to_dense());
+    EXPECT_EQ(TDynamicMatrix<double>(a * 3.0), (sa * 3.0).to_dense());
+    EXPECT_LE((sa + sb).nnz(), sa.nnz() + sb.nnz());
+    ASSERT_ANY_THROW(sa + TSparseMatrixCSR<double>(n, n + 1));
+}
+
+namespace
+{
+template<typename T>
+void expect_spmm_matches_spmv(const TSparseMatrixCSR<T>& a)
+{
+    const size_t n = a.rows();
+    TDynamicMatrix<T> x(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            x[i][j] = T(int((i * n + j) % 11) - 5);
+    TDynamicMatrix<T> y = a * x;
+    for (size_t j = 0; j < n; ++j) {
+        TDynamicVector<T> xj(n), yj(n);
+        for (size_t i = 0; i < n; ++i)
+            xj[i] = x[i][j];
+        a.multiply(xj, yj);
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(yj[i], y[i][j]) << "n = " << n << ", row " << i << ", vector " << j;
+    }
+}
+}
+
+TEST(TSparseMatrixCSR, spmm_matches_spmv_per_vector_at_every_cpu_level)
+{
+    //         ld()  size()
+    for (size_t n : { 3, 13, 67, 300 }) {
+        TDynamicMatrix<double> dd = make_sparse_dense(n, 4);
+        TDynamicMatrix<float> df(n);
+        TDynamicMatrix<int> di(n);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) {
+                df[i][j] = float(dd[i][j]);
+                di[i][j] = int(dd[i][j]);
+            }
+        TSparseMatrixCSR<double> ad(dd);
+        TSparseMatrixCSR<float> af(df);
+        TSparseMatrixCSR<int> ai(di);
+
+        for (int level = 0; level <= int(TCpu::detected()); ++level) {
+            TCpu::limit(TCpuLevel(level));
+            expect_spmm_matches_spmv(ad);
+            expect_spmm_matches_spmv(af);
+            expect_spmm_matches_spmv(ai);
+        }
+    }
+    TCpu::limit(TCpuLevel::AVX512);
+}
+
+TEST(TSparseMatrixCSR, parallel_spmm_matches_serial)
+{
+    TSparseMatrixCSR<double> a(make_sparse_dense(1000, 5));
+    TDynamicMatrix<double> x(1000), serial(1000), parallel(1000);
+    for (size_t i = 0; i < 1000; ++i)
+        for (size_t j = 0; j < 1000; ++j)
+            x[i][j] = double((i + j) % 7) - 3;
+
+    a.multiply(x, serial);
+    TThreadPool::set_threads(4);
+    a.multiply(x, parallel);
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST(TSparseMatrixCSR, spmm_applies_rectangular_matrix_to_narrow_block)
+{
+    // A 30000 x 20000,   k      k
+    const size_t rows = 30000, cols = 20000;
+    TSparseBuilder<double> b(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t q = 0; q < 1 + i % 6; ++q)
+            b.add(i, (i * 7 + q * 1231) % cols, double(int((i + q) % 9) - 4));
+    const TSparseMatrixCSR<double> a = b.build();
+
+    for (size_t k : { 8, 64 }) {
+        const size_t ldx = k + 3, ldy = k + 5;
+        vector<double> x(cols * ldx), y(rows * ldy, -1.0);
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = double(int(i % 13) - 6);
+
+        TThreadPool::set_threads(4);
+        a.multiply(x.data(), ldx, y.data(), ldy, k);
+        TThreadPool::set_threads(0);
+        for (size_t j = 0; j < k; ++j) {
+            TDynamicVector<double> xj(cols), yj(rows);
+            for (size_t i = 0; i < cols; ++i)
+                xj[i] = x[i * ldx + j];
+            a.multiply(xj, yj);
+            for (size_t i = 0; i < rows; ++i)
+                ASSERT_EQ(yj[i], y[i * ldy + j]) << "k = " << k << ", row " << i << ", vector " << j;
+        }
+        //    Y  
+        for (size_t i = 0; i < rows; ++i)
+            ASSERT_EQ(-1.0, y[i * ldy + k]);
+    }
+}
+
+TEST(TSparseMatrixCSR, spmm_checks_sizes_and_aliasing)
+{
+    TSparseMatrixCSR<double> a(make_sparse_dense(20, 1)), r(20, 21);
+    TDynamicMatrix<double> x(20), y(20), z(21);
+
+    ASSERT_ANY_THROW(a.multiply(x, z));
+    ASSERT_ANY_THROW(a.multiply(x, x));
+    ASSERT_ANY_THROW(r.multiply(x, y));
+    ASSERT_NO_THROW(a.multiply(x, y));
+
+    vector<double> bx(21 * 4), by(20 * 4);
+    ASSERT_ANY_THROW(r.multiply(bx.data(), 3, by.data(), 4, 4));
+    ASSERT_ANY_THROW(r.multiply(bx.data(), 4, bx.data() + 8, 4, 4));
+    ASSERT_ANY_THROW(r.multiply(bx.data(), 4, nullptr, 4, 4));
+    ASSERT_NO_THROW(r.multiply(bx.data(), 4, by.data(), 4, 4));
+}
+
+TEST(TSparseMatrixCSR, transpose_matches_dense)
+{
+    TDynamicMatrix<double> d = make_sparse_dense(400, 6);
+    TSparseMatrixCSR<double> a(d);
+    TDynamicMatrix<double> dt(400);
+    for (size_t i = 0; i < 400; ++i)
+        for (size_t j = 0; j < 400; ++j)
+            dt[j][i] = d[i][j];
+
+    EXPECT_EQ(TSparseMatrixCSR<double>(dt), a.transpose());
+    TThreadPool::set_threads(4);
+    EXPECT_EQ(TSparseMatrixCSR<double>(dt), a.transpose());
+    TThreadPool::set_threads(0);
+}
+
+TEST(TSparseMatrixCSR, transpose_of_rectangular_matrix)
+{
+    TSparseMatrixCSR<int> a(2, 3, { 0, 2, 3 }, { 0, 2, 1 }, { 1, 2, 3 });
+
+    EXPECT_EQ(TSparseMatrixCSR<int>(3, 2, { 0, 1, 2, 3 }, { 0, 1, 0 }, { 1, 3, 2 }), a.transpose());
+    EXPECT_EQ(a, a.transpose().transpose());
+}
+
+TEST(TSparseMatrixCSR, parallel_transpose_of_large_matrix)
+{
+    const size_t n = 100000;
+    vector<size_t> rp(n + 1, 0);
+    vector<uint32_t> ci;
+    vector<double> va;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < 4; ++k)
+            ci.push_back(uint32_t((i * 7 + k * 25013) % n));
+        std::sort(ci.end() - 4, ci.end());
+        for (size_t k = 0; k < 4; ++k)
+            va.push_back(double(i * 4 + k));
+        rp[i + 1] = ci.size();
+    }
+    TSparseMatrixCSR<double> a(n, n, rp, ci, va);
+
+    TSparseMatrixCSR<double> serial = a.transpose();
+    TThreadPool::set_threads(4);
+    TSparseMatrixCSR<double> parallel = a.transpose();
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(serial, parallel);
+    EXPECT_EQ(a, parallel.transpose());
+    EXPECT_EQ(a.get(5, 35), serial.get(35, 5));
+}
+
+TEST(TSparseMatrixCSC, converts_to_and_from_csr)
+{
+    TSparseMatrixCSR<int> a(2, 3, { 0, 2, 3 }, { 0, 2, 1 }, { 1, 2, 3 });
+    TSparseMatrixCSC<int> c(a);
+
+    EXPECT_EQ(2u, c.rows());
+    EXPECT_EQ(3u, c.cols());
+    EXPECT_EQ(vector<size_t>({ 0, 1, 2, 3 }), c.col_ptr());
+    EXPECT_EQ(vector<uint32_t>({ 0, 1, 0 }), c.row_idx());
+    EXPECT_EQ(2, c.get(0, 2));
+    EXPECT_EQ(a, c.to_csr());
+}
@@ -0,0 +1,111 @@
+#include "tsparsebuilder.h"
+
+#include <thread>
+
+#include <gtest.h>
+
+TEST(TSparseBuilder, can_create_builder)
+{
+    ASSERT_NO_THROW(TSparseBuilder<double> b(3, 4));
+    ASSERT_ANY_THROW(TSparseBuilder<double> b(0, 4));
+}
+
+TEST(TSparseBuilder, throws_on_index_out_of_range)
+{
+    TSparseBuilder<double> b(3, 4);
+    ASSERT_NO_THROW(b.add(2, 3, 1.0));
+    ASSERT_ANY_THROW(b.add(3, 0, 1.0));
+    ASSERT_ANY_THROW(b.add(0, 4, 1.0));
+}
+
+TEST(TSparseBuilder, empty_builder_gives_empty_matrix)
+{
+    TSparseBuilder<double> b(5, 2);
+    TSparseMatrixCSR<double> m = b.build();
+
+    EXPECT_EQ(5u, m.rows());
+    EXPECT_EQ(2u, m.cols());
+    EXPECT_EQ(0u, m.nnz());
+    EXPECT_EQ(vector<size_t>(6, 0), m.row_ptr());
+}
+
+TEST(TSparseBuilder, sorts_triplets_and_sums_duplicates)
+{
+    TSparseBuilder<int> b(4, 5);
+    b.add(3, 1, 2);
+    b.add(0, 4, 1);
+    b.add(3, 1, 5);
+    b.add(0, 0, 7);
+    b.add(2, 3, -1);
+    b.add(2, 3, 1);
+    TSparseMatrixCSR<int> m = b.build();
+
+    EXPECT_EQ(6u, b.size());
+    EXPECT_EQ(TSparseMatrixCSR<int>(4, 5, { 0, 2, 2, 3, 4 }, { 0, 4, 3, 1 }, { 7, 1, 0, 7 }), m);
+}
+
+TEST(TSparseBuilder, concurrent_insertion_matches_dense)
+{
+    const size_t n = 300, per_thread = 20000, threads = 4;
+    TSparseBuilder<double> b(n, n);
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+        workers.emplace_back([&b, t]() {
+            for (size_t k = 0; k < per_thread; ++k) {
+                const size_t x = (k * 7919 + t * 104729) % (n * n / 8);
+                b.add(x * 13 % n, x * 31 % n, double(k % 5) - 2);
+            }
+        });
+    for (thread& w : workers)
+        w.join();
+
+    TDynamicMatrix<double> expected(n);
+    for (size_t t = 0; t < threads; ++t)
+        for (size_t k = 0; k < per_thread; ++k) {
+            const size_t x = (k * 7919 + t * 104729) % (n * n / 8);
+            expected[x * 13 % n][x * 31 % n] += double(k % 5) - 2;
+        }
+
+    ASSERT_EQ(threads * per_thread, b.size());
+    EXPECT_EQ(expected, b.build().to_dense());
+    TThreadPool::set_threads(4);
+    TSparseMatrixCSR<double> m = b.build();
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(expected, m.to_dense());
+    EXPECT_EQ(m, b.build());
+}
+
+TEST(TSparseBuilder, interleaved_builders_keep_one_buffer_per_thread)
+{
+    const size_t n = 50, threads = 3;
+    TSparseBuilder<double> a(n, n), b(n, n);
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+        workers.emplace_back([&a, &b, t]() {
+            for (size_t k = 0; k < 1000; ++k) {
+                a.add((k + t) % n, k % n, 1.0);
+                b.add(k % n, (k + t) % n, 2.0);
+            }
+        });
+    for (thread& w : workers)
+        w.join();
+    for (size_t k = 0; k < 100; ++k) {
+        a.add(0, k % n, 1.0);
+        b.add(k % n, 0, 2.0);
+    }
+
+    EXPECT_EQ(threads + 1, a.buffer_count());
+    EXPECT_EQ(threads + 1, b.buffer_count());
+    EXPECT_EQ(threads * 1000 + 100, a.size());
+    EXPECT_EQ(threads * 1000 + 100, b.size());
+}
+
+TEST(TSparseBuilder, clear_removes_triplets)
+{
+    TSparseBuilder<double> b(2, 2);
+    b.add(1, 1, 3.0);
+    b.clear();
+    b.add(0, 1, 2.0);
+
+    EXPECT_EQ(TSparseMatrixCSR<double>(2, 2, { 0, 1, 1 }, { 1 }, { 2.0 }), b.build());
+}
@@ -0,0 +1,218 @@
+#include "tspgemm.h"
+#include "tsparsebuilder.h"
+
+#include <gtest.h>
+
+namespace
+{
+//    ,  10-  :  
+//    -,   
+TSparseMatrixCSR<double> make_mixed(size_t rows, size_t cols, unsigned seed)
+{
+    TSparseBuilder<double> b(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        const size_t len = i % 10 == 3 ? cols / 2 : 1 + (i + seed) % 4;
+        for (size_t k = 0; k < len; ++k)
+            b.add(i, (i * 37 + k * 7 + seed) % cols, double(int((i + k + seed) % 5) - 2));
+    }
+    return b.build();
+}
+
+TDynamicMatrix<double> dense_product(const TSparseMatrixCSR<double>& a, const TSparseMatrixCSR<double>& b)
+{
+    const size_t n = std::max(std::max(a.rows(), a.cols()), b.cols());
+    TDynamicMatrix<double> c(n);
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t k = 0; k < a.cols(); ++k) {
+            const double aik = a.get(i, k);
+            if (aik != 0)
+                for (size_t j = 0; j < b.cols(); ++j)
+                    c[i][j] += aik * b.get(k, j);
+        }
+    return c;
+}
+
+bool rows_sorted(const TSparseMatrixCSR<double>& c)
+{
+    for (size_t i = 0; i < c.rows(); ++i)
+        for (size_t k = c.row_ptr()[i] + 1; k < c.row_ptr()[i + 1]; ++k)
+            if (c.col_idx()[k - 1] >= c.col_idx()[k])
+                return false;
+    return true;
+}
+}
+
+TEST(TSpGemm, throws_on_mismatched_dimensions)
+{
+    ASSERT_ANY_THROW(TSpGemm<double>::multiply(TSparseMatrixCSR<double>(3, 4), TSparseMatrixCSR<double>(3, 4)));
+}
+
+TEST(TSpGemm, estimates_row_flops)
+{
+    TSparseMatrixCSR<int> a(2, 3, { 0, 2, 3 }, { 0, 2, 1 }, { 1, 1, 1 });
+    TSparseMatrixCSR<int> b(3, 2, { 0, 2, 2, 3 }, { 0, 1, 1 }, { 1, 1, 1 });
+
+    EXPECT_EQ(vector<size_t>({ 0, 3, 3 }), TSpGemm<int>::row_flops(a, b));
+    EXPECT_EQ(TSparseMatrixCSR<int>(2, 2, { 0, 2, 2 }, { 0, 1 }, { 1, 2 }), TSpGemm<int>::multiply(a, b));
+}
+
+TEST(TSpGemm, hash_spreads_strided_columns)
+{
+    //    1024 -      
+    std::vector<size_t> used;
+    for (uint32_t k = 0; k < 256; ++k)
+        used.push_back(TSpAccumulator<double>::slot(k * 1024, 9));
+    std::sort(used.begin(), used.end());
+
+    EXPECT_LE(250, std::unique(used.begin(), used.end()) - used.begin());
+    EXPECT_GT(512u, used.back());
+}
+
+TEST(TSpGemm, strided_columns_match_compact_product)
+{
+    // B   1024     -,  B -  SPA;
+    //       
+    const size_t rows = 50, inner = 200, width = 20, stride = 1024;
+    TSparseBuilder<double> ba(rows, inner), bs(inner, (inner + width) * stride), bc(inner, inner + width);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t k = 0; k < 10; ++k)
+            ba.add(i, (i * 3 + k) % inner, double(int((i + k) % 5) - 2));
+    for (size_t k = 0; k < inner; ++k)
+        for (size_t m = 0; m < width; ++m) {
+            bs.add(k, (k + m) * stride, double(int((k + m) % 7) - 3));
+            bc.add(k, k + m, double(int((k + m) % 7) - 3));
+        }
+    TSparseMatrixCSR<double> a = ba.build();
+    TSparseMatrixCSR<double> cs = TSpGemm<double>::multiply(a, bs.build());
+    TSparseMatrixCSR<double> cc = TSpGemm<double>::multiply(a, bc.build());
+
+    ASSERT_EQ(cc.row_ptr(), cs.row_ptr());
+    EXPECT_EQ(cc.values(), cs.values());
+    for (size_t p = 0; p < cc.nnz(); ++p)
+        ASSERT_EQ(size_t(cc.col_idx()[p]) * stride, size_t(cs.col_idx()[p]));
+}
+
+TEST(TSpGemm, square_product_matches_dense)
+{
+    TSparseMatrixCSR<double> a = make_mixed(300, 300, 1), b = make_mixed(300, 300, 2);
+    TSparseMatrixCSR<double> c = TSpGemm<double>::multiply(a, b);
+
+    EXPECT_TRUE(rows_sorted(c));
+    EXPECT_EQ(a.to_dense() * b.to_dense(), c.to_dense());
+}
+
+TEST(TSpGemm, rectangular_product_matches_dense)
+{
+    TSparseMatrixCSR<double> a = make_mixed(120, 200, 3), b = make_mixed(200, 90, 4);
+    TSparseMatrixCSR<double> c = TSpGemm<double>::multiply(a, b);
+    TDynamicMatrix<double> expected = dense_product(a, b);
+
+    ASSERT_EQ(120u, c.rows());
+    ASSERT_EQ(90u, c.cols());
+    EXPECT_TRUE(rows_sorted(c));
+    for (size_t i = 0; i < c.rows(); ++i)
+        for (size_t j = 0; j < c.cols(); ++j)
+            ASSERT_EQ(expected[i][j], c.get(i, j));
+}
+
+TEST(TSpGemm, parallel_product_matches_serial)
+{
+    TSparseMatrixCSR<double> a = make_mixed(5000, 5000, 5), b = make_mixed(5000, 5000, 6);
+    TSparseMatrixCSR<double> serial = TSpGemm<double>::multiply(a, b);
+
+    TThreadPool::set_threads(4);
+    TSparseMatrixCSR<double> parallel = TSpGemm<double>::multiply(a, b);
+    TThreadPool::set_threads(0);
+    EXPECT_EQ(serial, parallel);
+}
+
+namespace
+{
+//      
+TSparseMatrixCSR<double> make_graph(size_t n, const vector<pair<size_t, size_t>>& edges)
+{
+    TSparseBuilder<double> b(n, n);
+    for (const auto& e : edges) {
+        b.add(e.first, e.second, 1.0);
+        b.add(e.second, e.first, 1.0);
+    }
+    return b.build();
+}
+
+uint64_t brute_force_triangles(const TSparseMatrixCSR<double>& a)
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t j = i + 1; j < a.rows(); ++j)
+            if (a.get(i, j) != 0)
+                for (size_t k = j + 1; k < a.rows(); ++k)
+                    count += a.get(i, k) != 0 && a.get(j, k) != 0;
+    return count;
+}
+}
+
+TEST(TSpGemm, masked_product_keeps_only_mask_entries)
+{
+    TSparseMatrixCSR<double> a = make_mixed(200, 150, 7), b = make_mixed(150, 200, 8), m = make_mixed(200, 200, 9);
+    TSparseBuilder<double> tb(200, 150);
+    for (size_t i = 0; i < b.rows(); ++i)
+        for (size_t k = b.row_ptr()[i]; k < b.row_ptr()[i + 1]; ++k)
+            tb.add(b.col_idx()[k], i, b.values()[k]);
+    TSparseMatrixCSR<double> full = TSpGemm<double>::multiply(a, b);
+
+    TThreadPool::set_threads(4);
+    TSparseMatrixCSR<double> c = TSpGemm<double>::multiply_masked(m, a, tb.build());
+    TThreadPool::set_threads(0);
+    EXPECT_TRUE(rows_sorted(c));
+    size_t kept = 0;
+    for (size_t i = 0; i < c.rows(); ++i)
+        for (size_t j = 0; j < c.cols(); ++j) {
+            const auto first = m.col_idx().begin() + m.row_ptr()[i], last = m.col_idx().begin() + m.row_ptr()[i + 1];
+            const bool in_mask = std::binary_search(first, last, uint32_t(j));
+            ASSERT_EQ(in_mask ? full.get(i, j) : 0.0, c.get(i, j));
+            kept += in_mask && full.get(i, j) != 0;
+        }
+    EXPECT_GE(c.nnz(), kept);
+    ASSERT_ANY_THROW(TSpGemm<double>::multiply_masked(m, a, b));
+}
+
+TEST(TSpGemm, intersects_lists_of_very_different_length)
+{
+    vector<uint32_t> small = { 3, 500, 999 }, large(1000);
+    std::iota(large.begin(), large.end(), 0u);
+    vector<pair<size_t, size_t>> matches;
+    auto collect = [&](size_t p, size_t q) { matches.push_back({ p, q }); };
+
+    TSpGemm<double>::intersect(small.data(), small.size(), large.data(), large.size(), collect);
+    TSpGemm<double>::intersect(large.data(), large.size(), small.data(), small.size(), collect);
+    EXPECT_EQ((vector<pair<size_t, size_t>>({ { 0, 3 }, { 1, 500 }, { 2, 999 }, { 3, 0 }, { 500, 1 }, { 999, 2 } })),
+              matches);
+}
+
+TEST(TSpGemm, counts_triangles)
+{
+    // K4: 4 ;   5 :  
+    TSparseMatrixCSR<double> k4 = make_graph(4, { { 0, 1 }, { 0, 2 }, { 0, 3 }, { 1, 2 }, { 1, 3 }, { 2, 3 } });
+    TSparseMatrixCSR<double> c5 = make_graph(5, { { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 4 }, { 4, 0 } });
+
+    EXPECT_EQ(4u, TSpGemm<double>::triangle_count(k4));
+    EXPECT_EQ(0u, TSpGemm<double>::triangle_count(c5));
+}
+
+TEST(TSpGemm, triangle_count_matches_brute_force)
+{
+    const size_t n = 120;
+    vector<pair<size_t, size_t>> edges;
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i + 1; j < n; ++j)
+            if ((i * 131 + j * 71) % 17 == 0 || j == i + 1)
+                edges.push_back({ i, j });
+    TSparseMatrixCSR<double> g = make_graph(n, edges);
+
+    const uint64_t expected = brute_force_triangles(g);
+    EXPECT_GT(expected, 0u);
+    EXPECT_EQ(expected, TSpGemm<double>::triangle_count(g));
+    TThreadPool::set_threads(4);
+    EXPECT_EQ(expected, TSpGemm<double>::triangle_count(g));
+    TThreadPool::set_threads(0);
+}
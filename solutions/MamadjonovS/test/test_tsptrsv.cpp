@@ -0,0 +1,109 @@
+#include "tsptrsv.h"
+#include "tsparsebuilder.h"
+
+#include <gtest.h>
+
+namespace
+{
+//     :   
+//     
+TSparseMatrixCSR<double> make_system(size_t n, const vector<size_t>& offsets)
+{
+    TSparseBuilder<double> b(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        b.add(i, i, 8.0);
+        for (size_t d : offsets)
+            if (i >= d) {
+                b.add(i, i - d, -1.0);
+                b.add(i - d, i, 0.5);
+            }
+    }
+    return b.build();
+}
+
+//    x  
+TDynamicVector<double> triangle_times(const TSparseMatrixCSR<double>& a, bool lower, bool unit,
+                                      const TDynamicVector<double>& x)
+{
+    TDynamicVector<double> y(a.rows());
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t k = a.row_ptr()[i]; k < a.row_ptr()[i + 1]; ++k) {
+            const size_t j = a.col_idx()[k];
+            if (j == i)
+                y[i] += (unit ? 1.0 : a.values()[k]) * x[j];
+            else if ((j < i) == lower)
+                y[i] += a.values()[k] * x[j];
+        }
+    return y;
+}
+
+double max_error(const TDynamicVector<double>& a, const TDynamicVector<double>& b)
+{
+    double e = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        e = std::max(e, std::abs(a[i] - b[i]));
+    return e;
+}
+}
+
+TEST(TSpTrsv, builds_level_schedule)
+{
+    // L:  2   0,  3 -  2;  1 
+    TSparseMatrixCSR<double> a(4, 4, { 0, 1, 2, 4, 6 }, { 0, 1, 0, 2, 2, 3 }, { 1, 1, 1, 1, 1, 1 });
+    TSpTrsv<double> lower(a, TSpTrsv<double>::Triangle::Lower);
+    TSpTrsv<double> upper(a, TSpTrsv<double>::Triangle::Upper);
+
+    EXPECT_EQ(3u, lower.levels());
+    EXPECT_EQ(vector<size_t>({ 0, 2, 3, 4 }), lower.level_ptr());
+    EXPECT_EQ(vector<uint32_t>({ 0, 1, 2, 3 }), lower.level_rows());
+    EXPECT_EQ(1u, upper.levels());
+}
+
+TEST(TSpTrsv, throws_without_diagonal)
+{
+    TSparseMatrixCSR<double> a(2, 2, { 0, 1, 2 }, { 0, 0 }, { 1, 1 });
+
+    ASSERT_ANY_THROW(TSpTrsv<double>(a, TSpTrsv<double>::Triangle::Lower));
+    ASSERT_NO_THROW(TSpTrsv<double>(a, TSpTrsv<double>::Triangle::Lower, true));
+}
+
+TEST(TSpTrsv, solves_lower_and_upper_triangles)
+{
+    const size_t n = 3000;
+    TSparseMatrixCSR<double> a = make_system(n, { 1, 2, 37 });
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = double(i % 13) - 6;
+
+    for (bool lower : { true, false })
+        for (bool unit : { true, false }) {
+            TSpTrsv<double> t(a, lower ? TSpTrsv<double>::Triangle::Lower : TSpTrsv<double>::Triangle::Upper, unit);
+            EXPECT_LT(max_error(x, t.solve(a, triangle_times(a, lower, unit, x))), 1e-10);
+        }
+}
+
+TEST(TSpTrsv, analysis_is_reused_for_new_values_and_threads)
+{
+    //      10000 :   
+    const size_t n = 20000;
+    TSparseMatrixCSR<double> a = make_system(n, { 10000 });
+    TSpTrsv<double> t(a, TSpTrsv<double>::Triangle::Lower);
+    ASSERT_EQ(2u, t.levels());
+    TSparseMatrixCSR<double> a2 = a * 2.0;
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = double(i % 5);
+    TDynamicVector<double> b = triangle_times(a2, true, false, x);
+
+    TDynamicVector<double> serial = t.solve(a2, b);
+    TThreadPool::set_threads(4);
+    TDynamicVector<double> parallel(n);
+    t.solve(a2, b, parallel);
+    TThreadPool::set_threads(0);
+    EXPECT_LT(max_error(x, serial), 1e-10);
+    EXPECT_EQ(serial, parallel);
+
+    //   
+    t.solve(a2, b, b);
+    EXPECT_EQ(serial, b);
+}
@@ -0,0 +1,82 @@
+#include "tsymmetric.h"
+
+#include <gtest.h>
+
+namespace
+{
+TSymmetricMatrix<double> make_symmetric(size_t n, int seed)
+{
+    TSymmetricMatrix<double> m(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i; j < n; ++j)
+            m(i, j) = double(int((i * 3 + j * 5 + seed) % 13) - 6);
+    return m;
+}
+}
+
+TEST(TSymmetricMatrix, can_create_matrix_with_positive_length)
+{
+    ASSERT_NO_THROW(TSymmetricMatrix<int> m(5));
+    ASSERT_ANY_THROW(TSymmetricMatrix<int> m(0));
+}
+
+TEST(TSymmetricMatrix, both_index_orders_refer_to_one_element)
+{
+    TSymmetricMatrix<int> m(4);
+    m(3, 1) = 7;
+
+    EXPECT_EQ(7, m(1, 3));
+    EXPECT_EQ(7, m[1][3]);
+    EXPECT_EQ(7, m.at(3, 1));
+    ASSERT_ANY_THROW(m.at(4, 0));
+}
+
+TEST(TSymmetricMatrix, converts_to_and_from_dense)
+{
+    TSymmetricMatrix<double> s = make_symmetric(17, 1);
+    TDynamicMatrix<double> d = s.to_dense();
+
+    for (size_t i = 0; i < 17; ++i)
+        for (size_t j = 0; j < 17; ++j)
+            EXPECT_EQ(d[j][i], d[i][j]);
+    EXPECT_EQ(s, TSymmetricMatrix<double>(d));
+}
+
+TEST(TSymmetricMatrix, elementwise_operations_match_dense)
+{
+    TSymmetricMatrix<double> a = make_symmetric(30, 2), b = make_symmetric(30, 9);
+    TSymmetricMatrix<double> r = a * 2.0 - b;
+
+    EXPECT_EQ(a.to_dense() * 2.0 - b.to_dense(), r.to_dense());
+}
+
+TEST(TSymmetricMatrix, matrix_vector_product_matches_dense)
+{
+    for (size_t n : { 1, 40, 700 }) {
+        TSymmetricMatrix<double> a = make_symmetric(n, 4);
+        TDynamicVector<double> x(n);
+        for (size_t i = 0; i < n; ++i)
+            x[i] = double(i % 5) - 2;
+
+        TDynamicVector<double> expected = a.to_dense() * x;
+        EXPECT_EQ(expected, a * x);
+
+        TThreadPool::set_threads(4);
+        EXPECT_EQ(expected, a * x);
+        TThreadPool::set_threads(0);
+    }
+}
+
+TEST(TSymmetricMatrix, sum_with_transpose_and_gram_match_dense)
+{
+    const size_t n = 23;
+    TDynamicMatrix<double> m(n), t(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            m[i][j] = double(int((i * 7 + j) % 10) - 4);
+            t[j][i] = m[i][j];
+        }
+
+    EXPECT_EQ(TDynamicMatrix<double>(m + t), TSymmetricMatrix<double>::sum_with_transpose(m).to_dense());
+    EXPECT_EQ(t * m, TSymmetricMatrix<double>::gram(m).to_dense());
+}
@@ -0,0 +1,175 @@
+#include "ttriangular.h"
+
+#include <gtest.h>
+
+namespace
+{
+template<typename T>
+TUpperTriangularMatrix<T> make_upper(size_t n, int seed)
+{
+    TUpperTriangularMatrix<T> m(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i; j < n; ++j)
+            m[i][j] = T(int((i * 7 + j * 3 + seed) % 11) - 5);
+    return m;
+}
+
+template<typename T>
+TLowerTriangularMatrix<T> make_lower(size_t n, int seed)
+{
+    TLowerTriangularMatrix<T> m(n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j <= i; ++j)
+            m[i][j] = T(int((i * 5 + j * 2 + seed) % 9) - 4);
+    return m;
+}
+}
+
+TEST(TUpperTriangularMatrix, can_create_matrix_with_positive_length)
+{
+    ASSERT_NO_THROW(TUpperTriangularMatrix<int> m(5));
+}
+
+TEST(TUpperTriangularMatrix, throws_when_create_matrix_with_zero_or_too_large_length)
+{
+    ASSERT_ANY_THROW(TUpperTriangularMatrix<int> m(0));
+    ASSERT_ANY_THROW(TUpperTriangularMatrix<int> m(MAX_MATRIX_SIZE + 1));
+}
+
+TEST(TUpperTriangularMatrix, indexes_only_upper_half)
+{
+    TUpperTriangularMatrix<int> m(4);
+    m[1][3] = 7;
+    m[2][2] = 5;
+
+    EXPECT_EQ(7, m[1][3]);
+    EXPECT_EQ(7, m.get(1, 3));
+    EXPECT_EQ(0, m.get(3, 1));
+    EXPECT_EQ(5, m.at(2).at(2));
+    ASSERT_ANY_THROW(m.at(2).at(1));
+    ASSERT_ANY_THROW(m.at(4));
+}
+
+TEST(TUpperTriangularMatrix, converts_to_and_from_dense)
+{
+    TDynamicMatrix<int> d(3);
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            d[i][j] = int(i * 3 + j + 1);
+
+    TUpperTriangularMatrix<int> u(d);
+    TDynamicMatrix<int> back = u.to_dense();
+
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_EQ(j >= i ? d[i][j] : 0, back[i][j]);
+}
+
+TEST(TUpperTriangularMatrix, elementwise_operations_match_dense)
+{
+    const size_t n = 37;
+    TUpperTriangularMatrix<double> a = make_upper<double>(n, 1), b = make_upper<double>(n, 4);
+
+    TUpperTriangularMatrix<double> r = a + b * 2.0 - a * 3.0;
+    TDynamicMatrix<double> expected = a.to_dense() + b.to_dense() * 2.0 - a.to_dense() * 3.0;
+    EXPECT_EQ(expected, r.to_dense());
+
+    r += a;
+    r -= b;
+    r *= 2.0;
+    expected = (expected + a.to_dense() - b.to_dense()) * 2.0;
+    EXPECT_EQ(expected, r.to_dense());
+}
+
+TEST(TUpperTriangularMatrix, matrix_vector_product_matches_dense)
+{
+    const size_t n = 50;
+    TUpperTriangularMatrix<double> a = make_upper<double>(n, 2);
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = double(i % 4) - 1;
+
+    EXPECT_EQ(a.to_dense() * x, a * x);
+    ASSERT_ANY_THROW(a * TDynamicVector<double>(n + 1));
+}
+
+TEST(TUpperTriangularMatrix, product_is_upper_triangular_and_matches_dense)
+{
+    for (size_t n : { 1, 9, 130 }) {
+        TUpperTriangularMatrix<int> a = make_upper<int>(n, 3), b = make_upper<int>(n, 5);
+        EXPECT_EQ(a.to_dense() * b.to_dense(), (a * b).to_dense());
+    }
+    ASSERT_ANY_THROW(make_upper<int>(3, 0) * make_upper<int>(4, 0));
+}
+
+TEST(TUpperTriangularMatrix, product_is_the_same_on_several_threads)
+{
+    const size_t n = 300;
+    TUpperTriangularMatrix<double> a = make_upper<double>(n, 6), b = make_upper<double>(n, 8);
+    TUpperTriangularMatrix<double> serial = a * b;
+
+    TThreadPool::set_threads(4);
+    EXPECT_EQ(serial, a * b);
+    TThreadPool::set_threads(0);
+}
+
+TEST(TLowerTriangularMatrix, indexes_only_lower_half)
+{
+    TLowerTriangularMatrix<int> m(4);
+    m[3][1] = 7;
+
+    EXPECT_EQ(7, m[3][1]);
+    EXPECT_EQ(7, m.get(3, 1));
+    EXPECT_EQ(0, m.get(1, 3));
+    ASSERT_ANY_THROW(m.at(1).at(2));
+    ASSERT_ANY_THROW(m.at(4));
+}
+
+TEST(TLowerTriangularMatrix, converts_to_and_from_dense)
+{
+    TDynamicMatrix<int> d(3);
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            d[i][j] = int(i * 3 + j + 1);
+
+    TDynamicMatrix<int> back = TLowerTriangularMatrix<int>(d).to_dense();
+
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_EQ(j <= i ? d[i][j] : 0, back[i][j]);
+}
+
+TEST(TLowerTriangularMatrix, operations_match_dense)
+{
+    const size_t n = 45;
+    TLowerTriangularMatrix<double> a = make_lower<double>(n, 1), b = make_lower<double>(n, 3);
+    TDynamicVector<double> x(n);
+    for (size_t i = 0; i < n; ++i)
+        x[i] = double(i % 3) - 1;
+
+    EXPECT_EQ(a.to_dense() + b.to_dense() * 2.0, TLowerTriangularMatrix<double>(a + b * 2.0).to_dense());
+    EXPECT_EQ(a.to_dense() * x, a * x);
+    EXPECT_EQ(a.to_dense() * b.to_dense(), (a * b).to_dense());
+}
+
+TEST(TLowerTriangularMatrix, product_is_the_same_on_several_threads)
+{
+    const size_t n = 300;
+    TLowerTriangularMatrix<double> a = make_lower<double>(n, 2), b = make_lower<double>(n, 7);
+    TLowerTriangularMatrix<double> serial = a * b;
+
+    TThreadPool::set_threads(4);
+    EXPECT_EQ(serial, a * b);
+    TThreadPool::set_threads(0);
+}
+
+TEST(TLowerTriangularMatrix, transpose_is_upper_triangular)
+{
+    TLowerTriangularMatrix<int> l = make_lower<int>(20, 5);
+    TUpperTriangularMatrix<int> u = l.transpose();
+
+    for (size_t i = 0; i < 20; ++i)
+        for (size_t j = 0; j < 20; ++j)
+            EXPECT_EQ(l.get(i, j), u.get(j, i));
+    EXPECT_EQ(l, u.transpose());
+}
@@ -254,4 +254,138 @@ TEST(TDynamicVector, cant_multiply_vectors_with_not_equal_size)
     ASSERT_ANY_THROW(v1 * v2);
 }
 
- 
\ No newline at end of file
+TEST(TDynamicVector, vectorized_operations_match_scalar_ones_for_any_length)
+{
+    for (int level = 0; level <= int(TCpu::detected()); ++level) {
+        TCpu::limit(TCpuLevel(level));
+        for (size_t n = 1; n < 70; n += 3) {
+            TDynamicVector<int> a(n), b(n);
+            int dot = 0;
+            for (size_t i = 0; i < n; ++i) {
+                a[i] = int(i * 3) - 7;
+                b[i] = 11 - int(i);
+                dot += a[i] * b[i];
+            }
+
+            TDynamicVector<int> sum = a + b, diff = a - b, scaled = a * 4, shifted = a - 2;
+            for (size_t i = 0; i < n; ++i) {
+                ASSERT_EQ(a[i] + b[i], sum[i]);
+                ASSERT_EQ(a[i] - b[i], diff[i]);
+                ASSERT_EQ(a[i] * 4, scaled[i]);
+                ASSERT_EQ(a[i] - 2, shifted[i]);
+            }
+            ASSERT_EQ(dot, a * b);
+        }
+    }
+    TCpu::limit(TCpuLevel::AVX512);
+}
+
+TEST(TDynamicVector, kernels_handle_unaligned_head_and_tail)
+{
+    double a[37], b[37], r[37];
+    for (size_t i = 0; i < 37; ++i) {
+        a[i] = 0.5 * double(i);
+        b[i] = 2.0;
+    }
+
+    for (size_t offset = 0; offset < 8; ++offset) {
+        const size_t n = 37 - offset;
+        TVectorKernels<double>::add(a + offset, b, r + offset, n);
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(a[offset + i] + 2.0, r[offset + i]);
+        ASSERT_EQ(2.0 * 0.5 * double(n * (n - 1) / 2 + offset * n),
+                  TVectorKernels<double>::dot(a + offset, b, n));
+    }
+}
+
+TEST(TDynamicVector, chained_expression_is_evaluated_in_one_pass)
+{
+    const size_t n = 1000;
+    TDynamicVector<double> a(n), b(n), c(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = double(i);
+        b[i] = 2.0 * double(i);
+        c[i] = 1.0;
+    }
+
+    TDynamicVector<double> r = a + b - c * 2 + 1.0;
+
+    for (size_t i = 0; i < n; ++i)
+        ASSERT_EQ(3.0 * double(i) - 1.0, r[i]);
+}
+
+TEST(TDynamicVector, can_assign_expression_that_reads_target)
+{
+    TDynamicVector<int> a(300), b(300);
+    for (size_t i = 0; i < 300; ++i) {
+        a[i] = int(i);
+        b[i] = 1;
+    }
+
+    a = b * 2 + a;
+    a = hadamard(a, a - 2);
+
+    for (size_t i = 0; i < 300; ++i)
+        ASSERT_EQ(int(i) * (int(i) + 2), a[i]);
+}
+
+TEST(TDynamicVector, can_compare_expression_with_vector)
+{
+    TDynamicVector<int> v(3), w(3);
+    for (size_t i = 0; i < 3; ++i)
+        w[i] = int(i);
+
+    EXPECT_TRUE((v + w) == w);
+    EXPECT_TRUE(w == (v + w));
+    EXPECT_TRUE((v + 1) != w);
+    EXPECT_TRUE((w - 1 + 1) == (w * 1));
+    EXPECT_FALSE(hadamard(w, w) == w * 2);
+}
+
+TEST(TDynamicVector, cant_combine_expressions_with_not_equal_size)
+{
+    TDynamicVector<int> v1(3), v2(3), v3(4);
+
+    ASSERT_ANY_THROW(v1 + v2 - v3);
+    ASSERT_ANY_THROW(hadamard(v1, v3));
+}
+
+TEST(TDynamicVector, operations_on_expiring_vector_reuse_its_buffer)
+{
+    TDynamicVector<int> a(5), b(5);
+    for (size_t i = 0; i < 5; ++i) {
+        a[i] = int(i);
+        b[i] = 1;
+    }
+
+    TDynamicVector<int> t = a * 2;
+    const int* buffer = t.data();
+    TDynamicVector<int> r = std::move(t) + b - 3;
+    TDynamicVector<int> s = b - TDynamicVector<int>(a + 1);
+
+    ASSERT_EQ(buffer, r.data());
+    for (size_t i = 0; i < 5; ++i) {
+        ASSERT_EQ(2 * int(i) + 1 - 3, r[i]);
+        ASSERT_EQ(-int(i), s[i]);
+    }
+}
+
+TEST(TDynamicVector, compound_assignment_works_in_place)
+{
+    TDynamicVector<double> acc(300), delta(300);
+    for (size_t i = 0; i < 300; ++i)
+        delta[i] = double(i);
+    const double* buffer = acc.data();
+
+    acc += delta;
+    acc += delta * 2;
+    acc -= delta;
+    acc *= 0.5;
+    acc += 1.0;
+    acc -= 3.0;
+
+    ASSERT_EQ(buffer, acc.data());
+    for (size_t i = 0; i < 300; ++i)
+        ASSERT_EQ(double(i) - 2.0, acc[i]);
+    ASSERT_ANY_THROW(acc += TDynamicVector<double>(3));
+}